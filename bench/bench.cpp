@@ -0,0 +1,614 @@
+// micro- and macro-benchmarks for the hot paths of the game and the solver
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "../include/attack-tables.hpp"
+#include "../include/board-batch.hpp"
+#include "../include/board-renderer.hpp"
+#include "../include/chessboard.hpp"
+#include "../include/coord-conversions.hpp"
+#include "../include/difficulty-rater.hpp"
+#include "../include/move-list.hpp"
+#include "../include/notation.hpp"
+#include "../include/piece-type-enum.hpp"
+#include "../include/solution-counter.hpp"
+#include "../include/solver.hpp"
+#include "../include/symmetry.hpp"
+#include "../include/transposition-table.hpp"
+
+/* ALLOCATION COUNTING */
+
+namespace {
+  std::atomic<std::uint64_t> allocations{0};
+}
+
+// every heap allocation in the benchmark goes through here, so each
+// benchmark can report how many allocations one operation makes
+void* operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+    return memory;
+  }
+  throw std::bad_alloc{};
+}
+void operator delete(void* memory) noexcept {
+  std::free(memory);
+}
+void operator delete(void* memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+/* HELPER FUNCTIONS FOR MAIN */
+
+namespace {
+  // one benchmark's measurements
+  struct Result {
+    std::string name;
+    double ns_per_op;
+    double allocs_per_op;
+    // positions searched per second; 0 for benchmarks that don't search
+    double nodes_per_sec;
+  };
+
+  // keeps the compiler from optimizing away a value the benchmark computed
+  template <typename T>
+  void keep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+  }
+
+  // a stream that throws everything written to it away
+  class NullBuffer : public std::streambuf {
+    protected:
+      int overflow(int c) override { return c; }
+      std::streamsize xsputn(const char*, std::streamsize count) override {
+        return count;
+      }
+  };
+
+  // times 'iterations' calls of 'op', returning the elapsed time, the
+  // allocations made and the positions searched
+  struct Batch {
+    std::chrono::nanoseconds elapsed;
+    std::uint64_t allocated;
+    std::uint64_t nodes;
+  };
+  Batch runBatch(const std::function<std::uint64_t()>& op, std::uint64_t iterations) {
+    std::uint64_t nodes{0};
+    const std::uint64_t allocations_before = allocations.load();
+    const auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < iterations; i++) {
+      nodes += op();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return {elapsed, allocations.load() - allocations_before, nodes};
+  }
+
+  // grows the batch size until one batch takes at least 'min_time', then
+  // reports the cost of one call of 'op' from the fastest of five such batches
+  // (the fastest is the one least disturbed by the rest of the machine)
+  // 'op' returns the number of positions it searched (0 if it doesn't search)
+  Result measure(const std::string& name, const std::function<std::uint64_t()>& op,
+                 std::chrono::nanoseconds min_time = std::chrono::milliseconds(20)) {
+    std::uint64_t iterations{1};
+    while (runBatch(op, iterations).elapsed < min_time && iterations < (std::uint64_t{1} << 40)) {
+      iterations *= 2;
+    }
+    Batch best = runBatch(op, iterations);
+    for (int i = 0; i < 4; i++) {
+      if (const Batch batch = runBatch(op, iterations); batch.elapsed < best.elapsed) {
+        best = batch;
+      }
+    }
+    const double ns = std::chrono::duration<double, std::nano>(best.elapsed).count();
+    return {name, ns / iterations, static_cast<double>(best.allocated) / iterations,
+            best.nodes == 0 ? 0.0 : best.nodes / (ns / 1e9)};
+  }
+
+  // returns a busy board (level 19) with 'piece_type' swapped in at 3B
+  Chessboard boardWith(PieceType::PieceType piece_type) {
+    std::array<PieceType::PieceType, 16> outline{};
+    const Chessboard level{19};
+    for (int i = 0; i < 16; i++) {
+      outline[i] = level.typeAt(i);
+    }
+    outline[Coords::coordToIndex({3, 2})] = piece_type;
+    return Chessboard{outline};
+  }
+
+  // returns an N x N board with a random piece on about half its squares
+  template <int N>
+  BasicChessboard<N> halfFullBoard() {
+    std::mt19937_64 random{N};
+    std::array<PieceType::PieceType, N * N> outline{};
+    for (PieceType::PieceType& square : outline) {
+      if (random() % 2 == 0) {
+        square = static_cast<PieceType::PieceType>(1 + random() % 6);
+      }
+    }
+    return BasicChessboard<N>{outline};
+  }
+
+  // measures listing every capture on a half-full N x N board
+  template <int N>
+  Result measureAllMoves() {
+    const BasicChessboard<N> board = halfFullBoard<N>();
+    return measure("allMoves/" + std::to_string(N) + "x" + std::to_string(N), [&]() {
+      typename BasicChessboard<N>::MoveList moves;
+      board.getAllMoves(moves);
+      keep(moves);
+      return std::uint64_t{0};
+    });
+  }
+
+  // boards in the batch benchmarks
+  constexpr std::size_t kBatchBoards{4096};
+
+  // returns 'count' random boards of 2-8 pieces
+  std::vector<Chessboard> randomBoards(std::size_t count) {
+    std::mt19937_64 random{7};
+    std::vector<Chessboard> boards;
+    for (std::size_t i = 0; i < count; i++) {
+      std::uint64_t packed{0};
+      for (int pieces = 2 + static_cast<int>(random() % 7); pieces > 0;) {
+        const int square = static_cast<int>(random() % 16);
+        if (((packed >> (4 * square)) & 0xF) == 0) {
+          packed |= (1 + random() % 6) << (4 * square);
+          pieces--;
+        }
+      }
+      boards.push_back(Chessboard::fromPacked(packed));
+    }
+    return boards;
+  }
+
+  // returns the squares some piece on 'board' can capture, the scalar way
+  std::uint16_t captureTargets(const Chessboard& board) {
+    const std::uint16_t occ = board.getOccupancy();
+    std::uint16_t targets{0};
+    for (std::uint16_t pieces = occ; pieces != 0; pieces &= pieces - 1) {
+      const int square = __builtin_ctz(pieces);
+      targets |= Attacks::captures(board.typeAt(square), square, occ);
+    }
+    return targets;
+  }
+
+  // returns the number of boards on which a batch kernel this CPU supports
+  // disagrees with the scalar path, reporting every such board
+  int checkBatch(const std::vector<Chessboard>& boards, const BoardBatch& batch) {
+    static const char* const kKernels[3]{"scalar", "sse2", "avx2"};
+    int mismatches{0};
+    std::vector<std::uint16_t> targets(batch.size());
+    for (int kernel = 0; kernel < 3; kernel++) {
+      if (!BoardBatch::supports(static_cast<BoardBatch::Kernel>(kernel))) {
+        continue;
+      }
+      batch.captureTargets(targets.data(), static_cast<BoardBatch::Kernel>(kernel));
+      for (std::size_t i = 0; i < boards.size(); i++) {
+        if (targets[i] != captureTargets(boards[i])) {
+          std::cout << "MISMATCH batch/" << kKernels[kernel] << " on "
+                    << Notation::toString(boards[i].getPacked()) << "\n";
+          mismatches++;
+        }
+      }
+    }
+    return mismatches;
+  }
+
+  // big pawnless boards are the only ones remembered in canonical form, but
+  // take too long to play out to check them all; this many of them are
+  constexpr int kCheckedSymmetricBoards{8};
+
+  // returns the boards the solution counter and rater are checked on: every
+  // level and the first few big pawnless boards of 'random', turned and
+  // flipped every way, then the rest of 'random' that's small enough to play
+  // out quickly
+  std::vector<Chessboard> checkedBoards(const std::vector<Chessboard>& random) {
+    std::vector<std::uint64_t> images;
+    for (int level = 1; level <= 20; level++) {
+      images.push_back(Chessboard{level}.getPacked());
+    }
+    std::vector<Chessboard> boards;
+    for (const Chessboard& board : random) {
+      if (board.pieceCount() < TranspositionTable::kSymmetricPieces) {
+        boards.push_back(board);
+      } else if (images.size() < 20 + kCheckedSymmetricBoards &&
+                 !Symmetry::hasPawn(board.getPacked())) {
+        images.push_back(board.getPacked());
+      }
+    }
+    for (const std::uint64_t packed : images) {
+      for (int transform = 0; transform < Symmetry::kTransforms; transform++) {
+        boards.push_back(Chessboard::fromPacked(Symmetry::apply(transform, packed)));
+      }
+    }
+    return boards;
+  }
+
+  // a capture tree's figures (see DifficultyRater::Rating), worked out by
+  // playing out every capture sequence
+  struct Tree {
+    std::uint64_t size;
+    std::uint64_t solutions;
+    std::uint64_t dead_ends;
+    int first_mistake;
+    double win_chance;
+  };
+
+  // returns the figures of the capture tree of 'board', remembering nothing
+  Tree walkByHand(const Chessboard& board) {
+    const std::uint16_t occ = board.getOccupancy();
+    if ((occ & (occ - 1)) == 0) {
+      return {1, occ != 0 ? 1u : 0u, 0, 0, occ != 0 ? 1.0 : 0.0};
+    }
+    Tree tree{1, 0, 0, INT32_MAX, 0.0};
+    int branches{0};
+    bool can_lose{false};
+    for (std::uint16_t pieces = occ; pieces != 0; pieces &= pieces - 1) {
+      const int from = __builtin_ctz(pieces);
+      for (std::uint16_t captures = Attacks::captures(board.typeAt(from), from, occ);
+           captures != 0; captures &= captures - 1) {
+        Chessboard next = board;
+        next.makeMove(from, __builtin_ctz(captures));
+        const Tree child = walkByHand(next);
+        tree.size += child.size;
+        tree.solutions += child.solutions;
+        tree.dead_ends += child.dead_ends;
+        tree.win_chance += child.win_chance;
+        if (child.solutions == 0) {
+          can_lose = true;
+        } else {
+          tree.first_mistake = std::min(tree.first_mistake, child.first_mistake + 1);
+        }
+        branches++;
+      }
+    }
+    if (branches == 0) {
+      tree.dead_ends = 1;
+    } else {
+      tree.win_chance /= branches;
+    }
+    // a losing capture is possible right away, or the board can't be won
+    if (can_lose || tree.solutions == 0) {
+      tree.first_mistake = 0;
+    }
+    return tree;
+  }
+
+  // returns the number of boards on which SolutionCounter's count or
+  // isUnique disagrees with the solutions in 'trees' (one per board),
+  // reporting every such board; one counter checks them all, so its
+  // remembered counts (and its lower bounds, from isUnique) are checked too
+  int checkCounter(const std::vector<Chessboard>& boards, const std::vector<Tree>& trees) {
+    SolutionCounter counter;
+    int mismatches{0};
+    for (std::size_t i = 0; i < boards.size(); i++) {
+      const std::uint64_t expected = trees[i].solutions;
+      if (counter.isUnique(boards[i]) != (expected == 1) ||
+          counter.count(boards[i]) != expected) {
+        std::cout << "MISMATCH count on " << Notation::toString(boards[i].getPacked()) << ": "
+                  << counter.count(boards[i]) << " instead of " << expected << "\n";
+        mismatches++;
+      }
+    }
+    return mismatches;
+  }
+
+  // returns the number of boards whose DifficultyRater rating disagrees with
+  // their tree in 'trees', reporting every such board; one rater rates them
+  // all, so figures it remembers from one board and reuses for another are
+  // checked too (the win chance only to rounding, since the remembered
+  // figures may have been summed in another order)
+  int checkRater(const std::vector<Chessboard>& boards, const std::vector<Tree>& trees) {
+    DifficultyRater rater;
+    int mismatches{0};
+    for (std::size_t i = 0; i < boards.size(); i++) {
+      const DifficultyRater::Rating rating = rater.rate(boards[i]);
+      const Tree& tree = trees[i];
+      if (rating.tree_size != tree.size || rating.solutions != tree.solutions ||
+          rating.dead_ends != tree.dead_ends || rating.first_mistake != tree.first_mistake ||
+          std::abs(rating.random_win_chance - tree.win_chance) > 1e-9 * tree.win_chance) {
+        std::cout << "MISMATCH rate on " << Notation::toString(boards[i].getPacked())
+                  << ": tree " << rating.tree_size << "/" << tree.size << ", solutions "
+                  << rating.solutions << "/" << tree.solutions << ", dead ends "
+                  << rating.dead_ends << "/" << tree.dead_ends << ", first mistake "
+                  << rating.first_mistake << "/" << tree.first_mistake << ", win chance "
+                  << std::defaultfloat << std::setprecision(6) << rating.random_win_chance << "/" << tree.win_chance << "\n";
+        mismatches++;
+      }
+    }
+    return mismatches;
+  }
+
+  std::vector<Result> runBenchmarks() {
+    std::vector<Result> results;
+
+    static const char* const kNames[7]{"", "pawn", "rook", "knight", "bishop",
+                                       "queen", "king"};
+    for (int piece_type = PieceType::PAWN; piece_type <= PieceType::KING; piece_type++) {
+      const Chessboard board = boardWith(static_cast<PieceType::PieceType>(piece_type));
+      results.push_back(measure(std::string{"getMoves/"} + kNames[piece_type], [&]() {
+        keep(board.getMoves({3, 2}));
+        return std::uint64_t{0};
+      }));
+      results.push_back(measure(std::string{"moveList/"} + kNames[piece_type], [&]() {
+        MoveList moves;
+        board.getMoves(Coords::coordToIndex({3, 2}), moves);
+        keep(moves);
+        return std::uint64_t{0};
+      }));
+    }
+
+    results.push_back(measureAllMoves<4>());
+    results.push_back(measureAllMoves<5>());
+    results.push_back(measureAllMoves<6>());
+    results.push_back(measureAllMoves<8>());
+
+    const Chessboard level_board{20};
+    results.push_back(measure("updateBoard", [&]() {
+      Chessboard board = level_board;
+      keep(board);
+      board.updateBoard({1, 1}, {2, 2});
+      keep(board);
+      return std::uint64_t{0};
+    }));
+    Chessboard undo_board = level_board;
+    results.push_back(measure("makeMove+undo", [&]() {
+      undo_board.makeMove(Coords::coordToIndex({1, 1}), Coords::coordToIndex({2, 2}));
+      keep(undo_board);
+      undo_board.undo();
+      keep(undo_board);
+      return std::uint64_t{0};
+    }));
+    results.push_back(measure("board copy", [&]() {
+      Chessboard board = level_board;
+      keep(board);
+      return std::uint64_t{0};
+    }));
+
+    NullBuffer null_buffer;
+    std::ostream null_sink{&null_buffer};
+    results.push_back(measure("printBoard", [&]() {
+      level_board.printBoard(null_sink);
+      return std::uint64_t{0};
+    }));
+    // redraws only the two squares a capture changes
+    Chessboard after_capture = level_board;
+    after_capture.updateBoard({1, 1}, {2, 2});
+    BoardRenderer diff_renderer{BoardRenderer::Mode::DIFF};
+    bool flip{false};
+    results.push_back(measure("render/diff", [&]() {
+      diff_renderer.render(flip ? after_capture : level_board, null_sink);
+      flip = !flip;
+      return std::uint64_t{0};
+    }));
+
+    const std::string notation{"2R1/QP2/N3/4"};
+    results.push_back(measure("notation/parse", [&]() {
+      std::uint64_t packed{0};
+      keep(Notation::parse(notation, packed));
+      keep(packed);
+      return std::uint64_t{0};
+    }));
+    results.push_back(measure("notation/write", [&]() {
+      char text[Notation::kMaxLength];
+      keep(Notation::write(level_board.getPacked(), text));
+      keep(text);
+      return std::uint64_t{0};
+    }));
+
+    // "has any capture" for 4096 unrelated boards: one board and one
+    // piece at a time, then every batch kernel the CPU supports
+    const std::vector<Chessboard> boards = randomBoards(kBatchBoards);
+    BoardBatch batch;
+    for (const Chessboard& board : boards) {
+      batch.add(board);
+    }
+    std::vector<std::uint8_t> has_moves(batch.size());
+    results.push_back(measure("batch/per board", [&]() {
+      for (std::size_t i = 0; i < boards.size(); i++) {
+        has_moves[i] = captureTargets(boards[i]) != 0;
+      }
+      keep(has_moves.data());
+      return std::uint64_t{0};
+    }));
+    static const char* const kKernels[3]{"scalar", "sse2", "avx2"};
+    for (int kernel = 0; kernel < 3; kernel++) {
+      if (!BoardBatch::supports(static_cast<BoardBatch::Kernel>(kernel))) {
+        continue;
+      }
+      results.push_back(measure(std::string{"batch/"} + kKernels[kernel], [&]() {
+        batch.hasMoves(has_moves.data(), static_cast<BoardBatch::Kernel>(kernel));
+        keep(has_moves.data());
+        return std::uint64_t{0};
+      }));
+    }
+
+    const std::string display{"2C"};
+    results.push_back(measure("displayToCoord", [&]() {
+      keep(Coords::displayToCoord(display));
+      return std::uint64_t{0};
+    }));
+
+    // each solve starts from an empty table so it measures a full search;
+    // the table is small enough that clearing it costs little next to that
+    TranspositionTable table{16};
+    Solver solver{&table};
+    for (int level = 1; level <= 20; level++) {
+      const Chessboard board{level};
+      results.push_back(measure("solve/level " + std::to_string(level), [&]() {
+        table.clear();
+        const std::uint64_t nodes_before = solver.getNodes();
+        keep(solver.isSolvable(board));
+        return solver.getNodes() - nodes_before;
+      }));
+    }
+    return results;
+  }
+
+  // writes 'results' as JSON
+  void writeJson(const std::vector<Result>& results, std::ostream& out) {
+    out << "{\n  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); i++) {
+      const Result& result = results[i];
+      out << "    {\"name\": \"" << result.name << "\", \"ns_per_op\": "
+          << result.ns_per_op << ", \"allocs_per_op\": " << result.allocs_per_op
+          << ", \"nodes_per_sec\": " << result.nodes_per_sec << "}"
+          << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+  }
+
+  // reads the name and ns/op of every benchmark from JSON written by writeJson
+  std::vector<std::pair<std::string, double>> readJson(std::istream& in) {
+    std::vector<std::pair<std::string, double>> baseline;
+    const std::string text{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+    const std::string name_key{"\"name\": \""}, time_key{"\"ns_per_op\": "};
+    for (std::size_t at = text.find(name_key); at != std::string::npos;
+         at = text.find(name_key, at)) {
+      at += name_key.size();
+      const std::size_t name_end = text.find('"', at);
+      const std::size_t time_at = text.find(time_key, name_end);
+      if (name_end == std::string::npos || time_at == std::string::npos) {
+        break;
+      }
+      baseline.push_back({text.substr(at, name_end - at),
+                          std::strtod(text.c_str() + time_at + time_key.size(), nullptr)});
+    }
+    return baseline;
+  }
+
+  void printTable(const std::vector<Result>& results) {
+    std::cout << std::left << std::setw(20) << "benchmark" << std::right
+              << std::setw(14) << "ns/op" << std::setw(14) << "allocs/op"
+              << std::setw(16) << "nodes/sec" << "\n";
+    for (const Result& result : results) {
+      std::cout << std::left << std::setw(20) << result.name << std::right
+                << std::fixed << std::setprecision(1) << std::setw(14)
+                << result.ns_per_op << std::setprecision(2) << std::setw(14)
+                << result.allocs_per_op << std::setprecision(0) << std::setw(16)
+                << result.nodes_per_sec << "\n";
+    }
+  }
+
+  // prints every benchmark that got slower than 'baseline' by more than
+  // 'tolerance' (e.g. 0.1 = 10%)
+  // returns the number of such regressions
+  int compare(const std::vector<Result>& results,
+              const std::vector<std::pair<std::string, double>>& baseline,
+              double tolerance) {
+    int regressions{0};
+    for (const auto& [name, baseline_ns] : baseline) {
+      for (const Result& result : results) {
+        if (result.name != name || baseline_ns <= 0) {
+          continue;
+        }
+        const double change = result.ns_per_op / baseline_ns - 1;
+        if (change > tolerance) {
+          std::cout << "REGRESSION " << name << ": " << std::setprecision(1)
+                    << baseline_ns << " -> " << result.ns_per_op << " ns/op (+"
+                    << std::setprecision(0) << change * 100 << "%)\n";
+          regressions++;
+        }
+      }
+    }
+    return regressions;
+  }
+
+  // returns the value following 'option' in 'args', or 'fallback' if the
+  // option wasn't given
+  std::string optionValue(const std::vector<std::string>& args,
+                          const std::string& option, const std::string& fallback) {
+    for (std::size_t i = 0; i + 1 < args.size(); i++) {
+      if (args[i] == option) {
+        return args[i + 1];
+      }
+    }
+    return fallback;
+  }
+
+  // reads the --tolerance percentage from 'text' into 'tolerance' as a
+  // fraction, returning false if 'text' isn't a whole non-negative number
+  bool parseTolerance(std::string_view text, double& tolerance) {
+    double percent{};
+    const char* end = text.data() + text.size();
+    const auto [parsed_to, error] = std::from_chars(text.data(), end, percent);
+    if (text.empty() || error != std::errc{} || parsed_to != end || !(percent >= 0)) {
+      return false;
+    }
+    tolerance = percent / 100;
+    return true;
+  }
+}
+
+// usage: SolitaireChessBench [--json file] [--baseline file] [--tolerance pct]
+// --json writes the results as JSON; --baseline compares them against an
+// earlier --json file and exits with status 1 if anything got slower by more
+// than the tolerance (default 25%, since a shared machine easily
+// swings the fastest nanosecond-scale benchmarks by 10-20%)
+int main(int argc, char* argv[]) {
+  const std::vector<std::string> args(argv + 1, argv + argc);
+  // check the options before spending a minute on the benchmarks
+  double tolerance{};
+  if (const std::string text = optionValue(args, "--tolerance", "25");
+      !parseTolerance(text, tolerance)) {
+    std::cerr << "error: --tolerance must be a percentage, not \"" << text << "\".\n"
+              << "usage: SolitaireChessBench [--json file] [--baseline file] "
+                 "[--tolerance pct]\n";
+    return 1;
+  }
+  const std::vector<Result> results = runBenchmarks();
+  printTable(results);
+
+  // the batch kernels must agree with the scalar path before their times mean
+  // anything
+  const std::vector<Chessboard> boards = randomBoards(kBatchBoards);
+  BoardBatch batch;
+  for (const Chessboard& board : boards) {
+    batch.add(board);
+  }
+  if (checkBatch(boards, batch) != 0) {
+    return 1;
+  }
+  // so must the solution counter and the rater with trees walked the slow way
+  const std::vector<Chessboard> checked = checkedBoards(boards);
+  std::vector<Tree> trees;
+  for (const Chessboard& board : checked) {
+    trees.push_back(walkByHand(board));
+  }
+  if (checkCounter(checked, trees) + checkRater(checked, trees) != 0) {
+    return 1;
+  }
+
+  if (const std::string path = optionValue(args, "--json", ""); !path.empty()) {
+    std::ofstream file{path};
+    writeJson(results, file);
+  }
+
+  if (const std::string path = optionValue(args, "--baseline", ""); !path.empty()) {
+    std::ifstream file{path};
+    if (!file) {
+      std::cerr << "error: couldn't read baseline " << path << ".\n";
+      return 1;
+    }
+    const int regressions = compare(results, readJson(file), tolerance);
+    std::cout << regressions << " regression(s) against " << path << "\n";
+    return regressions == 0 ? 0 : 1;
+  }
+  return 0;
+}
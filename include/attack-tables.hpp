@@ -0,0 +1,281 @@
+// compile-time move tables for every piece type and square of every board size
+#ifndef ATTACK_TABLES_H
+#define ATTACK_TABLES_H
+
+#include <array>
+#include <cstdint>
+
+#include "board-traits.hpp"
+#include "piece-type-enum.hpp"
+
+/* All masks use the same square order as Chessboard: bit i is square i,
+ * counting left-to-right, top-to-bottom, so bit 0 is 4A and bit 15 is 1D.
+ *
+ * Leapers (pawn, knight, king) get one mask per square.
+ * Sliders (rook, bishop) get, per square, every possible occupancy of the
+ * lines through that square: the 16-bit board occupancy is squeezed down to
+ * an index of at most 6 bits (one lookup per occupancy byte), and that index
+ * picks the precomputed capture set. A queen is a rook OR a bishop.
+ *
+ * Bigger boards (see capturesOn) have too many lines through a square for
+ * tables like that, so their sliders walk rays instead.
+ */
+namespace Attacks {
+  using Mask = std::uint16_t;
+
+  // (row, column) steps; rows count down from the top, so "north" is -1
+  constexpr int kStraightSteps[4][2]{{-1, 0}, {0, 1}, {1, 0}, {0, -1}};
+  constexpr int kDiagonalSteps[4][2]{{-1, 1}, {-1, -1}, {1, 1}, {1, -1}};
+  constexpr int kKnightSteps[8][2]{{-2, 1}, {-2, -1}, {2, 1}, {2, -1},
+                                   {1, 2}, {-1, 2}, {1, -2}, {-1, -2}};
+
+  // returns the squares of an N x N board reached from 'square' by one of
+  // each of 'steps'
+  template <int N, int Count>
+  constexpr typename BoardTraits<N>::Mask leapMask(int square, const int (&steps)[Count][2]) {
+    typename BoardTraits<N>::Mask attacks{0};
+    for (int i = 0; i < Count; i++) {
+      const int r = square / N + steps[i][0], c = square % N + steps[i][1];
+      if (r >= 0 && r < N && c >= 0 && c < N) {
+        attacks |= typename BoardTraits<N>::Mask{1} << (N * r + c);
+      }
+    }
+    return attacks;
+  }
+
+  // returns the squares reached from 'square' by sliding along each of
+  // 'steps', stopping on (and including) the first square set in 'occ'
+  constexpr Mask slideMask(int square, const int (&steps)[4][2], Mask occ) {
+    Mask attacks{0};
+    for (int i = 0; i < 4; i++) {
+      for (int r = square / 4 + steps[i][0], c = square % 4 + steps[i][1];
+           r >= 0 && r < 4 && c >= 0 && c < 4; r += steps[i][0], c += steps[i][1]) {
+        attacks |= 1 << (4 * r + c);
+        if ((occ >> (4 * r + c)) & 1) {
+          break;
+        }
+      }
+    }
+    return attacks;
+  }
+
+  // returns the number of set bits in 'mask'
+  constexpr int bitCount(unsigned mask) {
+    int count{0};
+    for (; mask != 0; mask &= mask - 1) {
+      count++;
+    }
+    return count;
+  }
+
+  // lookup tables for one slider type
+  struct SliderTable {
+    // squares whose occupancy can change the slider's capture set
+    std::array<Mask, 16> lines;
+    // compressed index contributed by the low and high occupancy byte
+    std::array<std::array<std::uint8_t, 256>, 16> index_lo;
+    std::array<std::array<std::uint8_t, 256>, 16> index_hi;
+    // capture set (before masking with occupancy) for each compressed index
+    std::array<std::array<Mask, 64>, 16> captures;
+  };
+
+  // builds the tables for a slider moving along 'steps'
+  constexpr SliderTable makeSliderTable(const int (&steps)[4][2]) {
+    SliderTable table{};
+    for (int square = 0; square < 16; square++) {
+      const Mask lines = slideMask(square, steps, 0);
+      table.lines[square] = lines;
+
+      // packs the bits of 'byte' that lie on 'lines' next to each other,
+      // starting at bit 'first_bit'
+      auto compress = [lines](int byte, int shift, int first_bit) {
+        int index{0}, bit{first_bit};
+        for (int i = 0; i < 8; i++) {
+          if ((lines >> (shift + i)) & 1) {
+            index |= ((byte >> i) & 1) << bit;
+            bit++;
+          }
+        }
+        return static_cast<std::uint8_t>(index);
+      };
+      const int lo_bits = bitCount(lines & 0xFF);
+      for (int byte = 0; byte < 256; byte++) {
+        table.index_lo[square][byte] = compress(byte, 0, 0);
+        table.index_hi[square][byte] = compress(byte, 8, lo_bits);
+      }
+
+      // spreads every compressed index back over 'lines' to get the
+      // occupancy it stands for
+      for (int index = 0; index < (1 << bitCount(lines)); index++) {
+        Mask occ{0};
+        int bit{0};
+        for (int i = 0; i < 16; i++) {
+          if ((lines >> i) & 1) {
+            occ |= ((index >> bit) & 1) << i;
+            bit++;
+          }
+        }
+        table.captures[square][index] = slideMask(square, steps, occ);
+      }
+    }
+    return table;
+  }
+
+  // builds the per-square table for a leaper; the unused piece types get
+  // all-zero rows so every type can be looked up the same way
+  constexpr std::array<std::array<Mask, 16>, 7> makeLeaperTable() {
+    std::array<std::array<Mask, 16>, 7> table{};
+    for (int square = 0; square < 16; square++) {
+      // pawns only ever attack diagonally forward (up)
+      const int pawn_steps[2][2]{{kDiagonalSteps[0][0], kDiagonalSteps[0][1]},
+                                 {kDiagonalSteps[1][0], kDiagonalSteps[1][1]}};
+      table[PieceType::PAWN][square] = leapMask<4>(square, pawn_steps);
+      table[PieceType::KNIGHT][square] = leapMask<4>(square, kKnightSteps);
+      table[PieceType::KING][square] = leapMask<4>(square, kStraightSteps) |
+                                       leapMask<4>(square, kDiagonalSteps);
+    }
+    return table;
+  }
+
+  // builds, per square, the squares a pawn could have captured onto it from
+  // (one row down, one column over); the other leapers attack symmetrically
+  constexpr std::array<Mask, 16> makePawnOriginTable() {
+    std::array<Mask, 16> table{};
+    for (int square = 0; square < 16; square++) {
+      const int pawn_steps[2][2]{{kDiagonalSteps[2][0], kDiagonalSteps[2][1]},
+                                 {kDiagonalSteps[3][0], kDiagonalSteps[3][1]}};
+      table[square] = leapMask<4>(square, pawn_steps);
+    }
+    return table;
+  }
+
+  inline constexpr std::array<std::array<Mask, 16>, 7> kLeaper{makeLeaperTable()};
+  inline constexpr std::array<Mask, 16> kPawnOrigins{makePawnOriginTable()};
+  inline constexpr SliderTable kRook{makeSliderTable(kStraightSteps)};
+  inline constexpr SliderTable kBishop{makeSliderTable(kDiagonalSteps)};
+
+  // per piece type, whether it moves like a rook and/or a bishop
+  inline constexpr std::array<Mask, 7> kRookLike{0, 0, 0xFFFF, 0, 0, 0xFFFF, 0};
+  inline constexpr std::array<Mask, 7> kBishopLike{0, 0, 0, 0, 0xFFFF, 0xFFFF, 0};
+
+  // returns the squares a slider described by 'table' on 'square' attacks
+  constexpr Mask slide(const SliderTable& table, int square, Mask occ) {
+    return table.captures[square][table.index_lo[square][occ & 0xFF] |
+                                  table.index_hi[square][occ >> 8]];
+  }
+
+  // returns a mask of the occupied squares a 'piece_type' on 'square' can
+  // capture, given the occupancy mask 'occ' of the whole board
+  // (branch-free: every term is looked up and the unused ones masked away)
+  constexpr Mask captures(PieceType::PieceType piece_type, int square, Mask occ) {
+    return ((kLeaper[piece_type][square]) |
+            (slide(kRook, square, occ) & kRookLike[piece_type]) |
+            (slide(kBishop, square, occ) & kBishopLike[piece_type])) & occ;
+  }
+
+  // returns a mask of the empty squares from which a 'piece_type' could have
+  // captured onto 'square' (the reverse of captures), given the occupancy
+  // mask 'occ' after that capture
+  // sliders move symmetrically, so that's every empty square they could slide
+  // to from 'square'; 'square' itself is occupied in both positions, so the
+  // paths are the same before and after the capture
+  constexpr Mask origins(PieceType::PieceType piece_type, int square, Mask occ) {
+    const Mask leaps = piece_type == PieceType::PAWN ? kPawnOrigins[square]
+                                                    : kLeaper[piece_type][square];
+    return (leaps |
+            (slide(kRook, square, occ) & kRookLike[piece_type]) |
+            (slide(kBishop, square, occ) & kBishopLike[piece_type])) & ~occ;
+  }
+
+  // the eight directions a slider can move in, kStraightSteps then
+  // kDiagonalSteps
+  constexpr int kRaySteps[8][2]{{-1, 0}, {0, 1}, {1, 0}, {0, -1},
+                                {-1, 1}, {-1, -1}, {1, 1}, {1, -1}};
+
+  // returns the squares of an N x N board along 'step' from 'square' to the
+  // edge, 'square' itself not included
+  template <int N>
+  constexpr typename BoardTraits<N>::Mask rayMask(int square, const int (&step)[2]) {
+    typename BoardTraits<N>::Mask ray{0};
+    for (int r = square / N + step[0], c = square % N + step[1];
+         r >= 0 && r < N && c >= 0 && c < N; r += step[0], c += step[1]) {
+      ray |= typename BoardTraits<N>::Mask{1} << (N * r + c);
+    }
+    return ray;
+  }
+
+  // lookup tables for an N x N board bigger than 4x4
+  template <int N>
+  struct RayTables {
+    // per piece type and square, like kLeaper
+    std::array<std::array<typename BoardTraits<N>::Mask, N * N>, 7> leaper;
+    // per kRaySteps direction and square, the squares along that ray
+    std::array<std::array<typename BoardTraits<N>::Mask, N * N>, 8> rays;
+  };
+
+  template <int N>
+  constexpr RayTables<N> makeRayTables() {
+    RayTables<N> tables{};
+    for (int square = 0; square < N * N; square++) {
+      const int pawn_steps[2][2]{{kDiagonalSteps[0][0], kDiagonalSteps[0][1]},
+                                 {kDiagonalSteps[1][0], kDiagonalSteps[1][1]}};
+      tables.leaper[PieceType::PAWN][square] = leapMask<N>(square, pawn_steps);
+      tables.leaper[PieceType::KNIGHT][square] = leapMask<N>(square, kKnightSteps);
+      tables.leaper[PieceType::KING][square] = leapMask<N>(square, kStraightSteps) |
+                                               leapMask<N>(square, kDiagonalSteps);
+      for (int direction = 0; direction < 8; direction++) {
+        tables.rays[direction][square] = rayMask<N>(square, kRaySteps[direction]);
+      }
+    }
+    return tables;
+  }
+
+  template <int N>
+  inline constexpr RayTables<N> kRays{makeRayTables<N>()};
+
+  // returns the occupied squares a slider on 'square' of an N x N board
+  // captures along directions 'First' to 'First' + 3, given the occupancy
+  // 'occ': the nearest occupied square of each ray, which is the lowest set
+  // bit of the ray's occupied squares if the ray runs towards higher square
+  // numbers and the highest set bit if it runs towards lower ones
+  template <int N, int First>
+  constexpr typename BoardTraits<N>::Mask slideRays(int square,
+                                                    typename BoardTraits<N>::Mask occ) {
+    using RayMask = typename BoardTraits<N>::Mask;
+    RayMask attacks{0};
+    for (int direction = First; direction < First + 4; direction++) {
+      const RayMask blockers = kRays<N>.rays[direction][square] & occ;
+      if (blockers == 0) {
+        continue;
+      }
+      if (kRaySteps[direction][0] * N + kRaySteps[direction][1] > 0) {
+        attacks |= blockers & (~blockers + 1);
+      } else {
+        attacks |= RayMask{1} << (63 - __builtin_clzll(blockers));
+      }
+    }
+    return attacks;
+  }
+
+  // captures on an N x N board: the 4x4 board uses the tables above, every
+  // bigger one the leaper and ray tables of its size
+  template <int N>
+  constexpr typename BoardTraits<N>::Mask capturesOn(PieceType::PieceType piece_type,
+                                                     int square,
+                                                     typename BoardTraits<N>::Mask occ) {
+    if constexpr (N == 4) {
+      return captures(piece_type, square, occ);
+    } else {
+      typename BoardTraits<N>::Mask attacks = kRays<N>.leaper[piece_type][square] & occ;
+      if (piece_type == PieceType::ROOK || piece_type == PieceType::QUEEN) {
+        attacks |= slideRays<N, 0>(square, occ);
+      }
+      if (piece_type == PieceType::BISHOP || piece_type == PieceType::QUEEN) {
+        attacks |= slideRays<N, 4>(square, occ);
+      }
+      return attacks;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,60 @@
+// (non-) member functions of BoardBatch class forward declared here
+#ifndef BOARD_BATCH_H
+#define BOARD_BATCH_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "chessboard.hpp"
+
+/* Many unrelated boards stored piece type by piece type (structure of
+ * arrays): one 16-bit mask per board for each type, so the masks of 8 (SSE2)
+ * or 16 (AVX2) boards sit next to each other and fill one vector register.
+ *
+ * The kernel answers, for every board at once, which squares some piece can
+ * capture, with shifts and masks in place of Attacks' per-square tables:
+ * leapers move their whole mask by each step, and sliders flood-fill each
+ * direction up to three squares, stopping at pieces. The scalar kernel runs
+ * the very same code on one board at a time, and every kernel agrees with
+ * Chessboard::getCaptures.
+ */
+class BoardBatch {
+  public:
+    enum class Kernel { SCALAR, SSE2, AVX2 };
+
+    // returns the fastest kernel this CPU supports
+    static Kernel bestKernel();
+    // returns true if this CPU can run 'kernel'
+    static bool supports(Kernel kernel);
+
+    void add(const Chessboard& board) { add(board.getPacked()); }
+    // adds the board whose packed position (see Chessboard::getPacked) is
+    // 'packed'
+    void add(std::uint64_t packed);
+    void clear();
+    std::size_t size() const { return size_; }
+
+    // writes, for each board in the order they were added, a mask of the
+    // squares some piece on it can capture, to 'out' (size() entries)
+    void captureTargets(std::uint16_t* out, Kernel kernel = bestKernel()) const;
+    // writes, for each board, 1 if any piece on it can capture, 0 otherwise
+    void hasMoves(std::uint8_t* out, Kernel kernel = bestKernel()) const;
+
+  private:
+    // writes the capture masks of the 'count' boards from board 'first' (a
+    // multiple of kBlock) on to 'out'
+    void captureTargets(std::size_t first, std::size_t count, std::uint16_t* out,
+                        Kernel kernel) const;
+
+    // boards per block; storage is always a whole number of blocks, the
+    // unused tail being empty boards, so the widest kernel never runs short
+    static constexpr std::size_t kBlock{16};
+
+    // per piece type (pawn first), one mask per board
+    std::array<std::vector<std::uint16_t>, 6> masks_;
+    std::size_t size_{0};
+};
+
+#endif
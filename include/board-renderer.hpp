@@ -0,0 +1,45 @@
+// (non-) member functions of BoardRenderer class forward declared here
+#ifndef BOARD_RENDERER_H
+#define BOARD_RENDERER_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "chessboard.hpp"
+
+// draws a board by composing the whole frame into one preallocated buffer
+// and handing it to the stream in a single write
+// in DIFF mode the first frame clears the terminal and is drawn at the top;
+// later frames only redraw the squares that changed since the previous one,
+// using ANSI cursor positioning, then park the cursor below the board
+class BoardRenderer {
+  public:
+    enum class Mode { FULL, DIFF };
+
+    BoardRenderer(Mode mode = Mode::FULL);
+
+    // draws 'board' to 'out' with a single write, then flushes 'out'
+    void render(const Chessboard& board, std::ostream& out);
+    // forgets the previous frame, so the next DIFF frame is drawn in full
+    void reset();
+
+    // returns the bytes written by the last render
+    std::string_view getFrame() const;
+
+  private:
+    void composeFull(const Chessboard& board);
+    void composeDiff(const Chessboard& board);
+    // appends line 'line' (0-6) of the image of the piece on square 'index'
+    void appendImageLine(const Chessboard& board, int index, int line);
+    // appends the ANSI sequence moving the cursor to 'row', 'column' (1-based)
+    void appendCursor(int row, int column);
+
+    Mode mode_;
+    std::string buffer_;
+    std::uint64_t previous_{0};
+    bool drawn_{false};
+};
+
+#endif
@@ -0,0 +1,51 @@
+// compile-time properties of the N x N boards, 4x4 up to 8x8
+#ifndef BOARD_TRAITS_H
+#define BOARD_TRAITS_H
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+/* Every board size numbers its squares the same way: left-to-right,
+ * top-to-bottom from 0, so square i of an N x N board is row i / N (counting
+ * down from the top) and column i % N. Masks have bit i set for square i, and
+ * positions are packed four bits (a PieceType) per square, sixteen squares
+ * per 64-bit word.
+ *
+ * Everything sized by the board is picked here, so each size gets the
+ * narrowest types that fit it: the 4x4 board keeps its 16-bit masks and
+ * single-word positions, a 5x5 board uses 32-bit masks and two words, and so
+ * on up to 64-bit masks and four words for 8x8.
+ */
+template <int N>
+struct BoardTraits {
+  static_assert(N >= 4 && N <= 8, "boards are 4x4 up to 8x8");
+
+  static constexpr int kSize{N};
+  static constexpr int kSquares{N * N};
+
+  // one bit per square
+  using Mask = std::conditional_t<
+      (kSquares <= 16), std::uint16_t,
+      std::conditional_t<(kSquares <= 32), std::uint32_t, std::uint64_t>>;
+  // every square of the board set
+  static constexpr Mask kAllSquares{
+      kSquares == 64 ? ~Mask{0} : static_cast<Mask>((std::uint64_t{1} << kSquares) - 1)};
+
+  // 64-bit words of the packed position
+  static constexpr int kWords{(kSquares + 15) / 16};
+  // the packed position: a plain word on the 4x4 board, so it can be passed
+  // around (and stored, hashed and compared) like before, an array otherwise
+  using Packed = std::conditional_t<kWords == 1, std::uint64_t,
+                                    std::array<std::uint64_t, kWords>>;
+
+  // bits a square index takes up in a move record
+  static constexpr int kSquareBits{kSquares <= 16 ? 4 : 6};
+  // captures a game can have (one fewer than the squares)
+  static constexpr int kMaxHistory{kSquares - 1};
+  // no piece can capture more than 8 others, so this many captures covers
+  // every capture on a full board at once
+  static constexpr int kMaxCaptures{kSquares * 8};
+};
+
+#endif
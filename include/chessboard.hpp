@@ -3,44 +3,246 @@
 #define CHESSBOARD_H
 
 #include <array>
+#include <cstdint>
+#include <iostream>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "attack-tables.hpp"
+#include "board-traits.hpp"
+#include "coord-conversions.hpp"
+#include "level-pack.hpp"
+#include "move.hpp"
+#include "move-list.hpp"
 #include "piece.hpp"
+#include "stats.hpp"
+#include "zobrist.hpp"
 
-// a class with board properties
-class Chessboard {
+// a class with board properties, for an N x N board (4x4 up to 8x8; the game
+// itself is played on Chessboard, the 4x4 one)
+// the whole position is packed four bits (a PieceType) per square, into one
+// 64-bit word on the 4x4 board (see BoardTraits), next to its Zobrist hash
+// every move is also recorded on a small move stack (a game never has more
+// captures than one fewer than the squares), so moves can be taken back and
+// replayed in place; the 4x4 board is still under 64 bytes, and every size is
+// trivially copyable
+// every size is compiled separately, with the mask widths, tables and index
+// arithmetic of its own size, so none of them pays for the others
+template <int N>
+class BasicChessboard {
   public:
-    Chessboard(int level);
+    using Traits = BoardTraits<N>;
+    // one bit per square
+    using Mask = typename Traits::Mask;
+    // the packed position (see getPacked)
+    using Packed = typename Traits::Packed;
+    // big enough for every capture on the board at once
+    using MoveList = BasicMoveList<Traits::kMaxCaptures>;
 
-    void printBoard();
-    const std::array<Piece, 16>& getBoard() const;
+    // constructor for an empty board
+    BasicChessboard() : squares_{}, hash_(0) {}
+    // 4x4 boards only: the levels are 4x4
+    BasicChessboard(int level, const LevelPack& pack = LevelPack::builtin());
+    BasicChessboard(const std::array<PieceType::PieceType, N * N>& outline);
+#if SOLITAIRE_CHESS_STATS
+    // copies are counted in stats builds only; everywhere else the board
+    // stays trivially copyable
+    BasicChessboard(const BasicChessboard& other)
+        : squares_(other.squares_), hash_(other.hash_), history_(other.history_),
+          history_size_(other.history_size_), redo_size_(other.redo_size_) {
+      STATS_ADD(Stats::BOARD_COPIES, 1);
+    }
+    BasicChessboard& operator=(const BasicChessboard& other) {
+      squares_ = other.squares_;
+      hash_ = other.hash_;
+      history_ = other.history_;
+      history_size_ = other.history_size_;
+      redo_size_ = other.redo_size_;
+      STATS_ADD(Stats::BOARD_COPIES, 1);
+      return *this;
+    }
+#endif
+    // returns the board whose packed position (see getPacked) is 'packed'
+    static BasicChessboard fromPacked(Packed packed);
+
+    // draws the board to 'out' (the terminal by default); 4x4 boards only
+    void printBoard(std::ostream& out = std::cout) const;
+    std::array<Piece, N * N> getBoard() const;
+
+    // returns the packed position; square i lives in bits 4i-4i+3 (of word
+    // i / 16, on boards bigger than 4x4, and bits 4(i % 16) on)
+    Packed getPacked() const { return squares_; }
+    // returns the Zobrist hash of the position, kept up to date by every move
+    std::uint64_t getHash() const { return hash_; }
+    // returns a mask with bit i set if square i holds a piece
+    Mask getOccupancy() const { return occupancyOf(squares_); }
+    // returns the same mask for the packed position 'packed'
+    static constexpr Mask occupancyOf(const Packed& packed) {
+      if constexpr (Traits::kWords == 1) {
+        return gatherNibbles(packed);
+      } else {
+        Mask occ{0};
+        for (int word = 0; word < Traits::kWords; word++) {
+          occ |= static_cast<Mask>(static_cast<Mask>(gatherNibbles(packed[word])) << (16 * word));
+        }
+        return occ;
+      }
+    }
+    // returns a mask with bit i set if square i holds a piece of 'piece_type'
+    Mask getTypeMask(PieceType::PieceType piece_type) const;
+    // returns the number of pieces left on the board
+    int pieceCount() const;
+    // returns the piece type on square 'index' (0 to N*N-1)
+    PieceType::PieceType typeAt(int index) const {
+      return static_cast<PieceType::PieceType>((wordOf(index) >> shiftOf(index)) & 0xF);
+    }
+
+    // returns a mask of the squares the piece on square 'index' can capture
+    Mask getCaptures(int index) const {
+      return Attacks::capturesOn<N>(typeAt(index), index, getOccupancy());
+    }
 
     void updateBoard(const std::pair<int, int>& old_pos,
                      const std::pair<int, int>& new_pos);
+    // moves the piece on square 'from' onto square 'to' (both 0 to N*N-1),
+    // replacing whatever was there
+    void makeMove(int from, int to) {
+      const std::uint64_t mover = (wordOf(from) >> shiftOf(from)) & 0xF;
+      const std::uint64_t captured = (wordOf(to) >> shiftOf(to)) & 0xF;
+      hash_ ^= Zobrist::kBoardKeys<N>[mover][from] ^ Zobrist::kBoardKeys<N>[captured][to] ^
+               Zobrist::kBoardKeys<N>[mover][to];
+      // clears both squares, then drops the mover's nibble onto 'to'
+      wordOf(from) &= ~(0xFULL << shiftOf(from));
+      wordOf(to) &= ~(0xFULL << shiftOf(to));
+      wordOf(to) |= mover << shiftOf(to);
+      // records from, to, captured and mover
+      if (history_size_ < kMaxHistory) {
+        history_[history_size_++] = static_cast<Record>(
+            from | (to << kSquareBits) | (captured << (2 * kSquareBits)) |
+            (mover << (2 * kSquareBits + 4)));
+      }
+      redo_size_ = history_size_;
+    }
+
+    // takes back the last move; returns false if there's none to take back
+    bool undo() {
+      if (history_size_ == 0) {
+        return false;
+      }
+      const Record record = history_[--history_size_];
+      const int from = record & kSquareField, to = (record >> kSquareBits) & kSquareField;
+      const std::uint64_t captured = (record >> (2 * kSquareBits)) & 0xF,
+                          mover = record >> (2 * kSquareBits + 4);
+      hash_ ^= Zobrist::kBoardKeys<N>[mover][from] ^ Zobrist::kBoardKeys<N>[captured][to] ^
+               Zobrist::kBoardKeys<N>[mover][to];
+      wordOf(to) &= ~(0xFULL << shiftOf(to));
+      wordOf(to) |= captured << shiftOf(to);
+      wordOf(from) |= mover << shiftOf(from);
+      return true;
+    }
+    // plays the last move taken back again; returns false if there's none
+    // (any new move discards the moves that could be replayed)
+    bool redo();
+    // returns the number of moves on the move stack
+    int getMovesPlayed() const { return history_size_; }
+    bool canUndo() const { return history_size_ != 0; }
+    bool canRedo() const { return history_size_ != redo_size_; }
+    // returns the last move played (only if canUndo())
+    Move getLastMove() const;
+
     bool spotOccupied(const std::pair<int, int>& coordinate) const;
     std::vector<std::pair<int, int>> getMoves(const std::pair<int, int>& position) const;
+    // appends the captures of the piece on square 'index' to 'moves'
+    void getMoves(int index, MoveList& moves) const;
+    // appends every capture of every piece on the board to 'moves'
+    void getAllMoves(MoveList& moves) const;
+    // returns true if the piece at 'position' can capture anything, without
+    // listing the captures
+    bool hasMoves(const std::pair<int, int>& position) const;
+    // returns the number of captures the piece at 'position' can make
+    int moveCount(const std::pair<int, int>& position) const;
 
-    Piece& operator[](int index);
-    const Piece& operator[](int index) const;
-    Piece& operator[](const std::pair<int, int>& coord);
-    const Piece& operator[](const std::pair<int, int>& coord) const;
+    Piece operator[](int index) const;
+    Piece operator[](const std::pair<int, int>& coord) const;
 
   private:
-    // array of all pieces on board, including empty spaces, in left-to-right,
-    // top-to-bottom order
-    std::array<Piece, 16> board_;
+    static constexpr int kMaxHistory{Traits::kMaxHistory};
+    // a move stack entry: from | to << kSquareBits | captured << 2 *
+    // kSquareBits | mover << (2 * kSquareBits + 4), which is one nibble each
+    // on the 4x4 board
+    static constexpr int kSquareBits{Traits::kSquareBits};
+    static constexpr int kSquareField{(1 << kSquareBits) - 1};
+    using Record = std::conditional_t<(2 * kSquareBits + 8 <= 16), std::uint16_t, std::uint32_t>;
+
+    // collapses the lowest bit of every nibble of 'nibbles' into a 16-bit mask
+    static constexpr std::uint16_t gatherNibbles(std::uint64_t nibbles);
+    // returns the Zobrist hash of the packed position 'packed'
+    static std::uint64_t hashOf(const Packed& packed);
+
+    // returns the word of the packed position holding square 'index'
+    std::uint64_t wordOf(int index) const {
+      if constexpr (Traits::kWords == 1) {
+        return squares_;
+      } else {
+        return squares_[index >> 4];
+      }
+    }
+    std::uint64_t& wordOf(int index) {
+      if constexpr (Traits::kWords == 1) {
+        return squares_;
+      } else {
+        return squares_[index >> 4];
+      }
+    }
+    // returns the lowest bit of square 'index' in its word
+    static constexpr int shiftOf(int index) {
+      return Traits::kWords == 1 ? 4 * index : 4 * (index & 15);
+    }
+
+    // all squares on board, including empty spaces, in left-to-right,
+    // top-to-bottom order, four bits per square
+    Packed squares_;
+    // XOR of Zobrist::kBoardKeys<N> for every piece on the board
+    std::uint64_t hash_;
+    // the moves played, oldest first, then the moves taken back (up to
+    // 'redo_size_')
+    std::array<Record, kMaxHistory> history_{};
+    std::uint8_t history_size_{0};
+    std::uint8_t redo_size_{0};
 };
 
-namespace {
-  // returns vector of Pieces based on return value of getStartingBoard(level)
-  std::array<Piece, 16> setUpBoard(int level);
+// the board the game is played on
+using Chessboard = BasicChessboard<4>;
+
+// collapses the lowest bit of every nibble of 'nibbles' into a 16-bit mask;
+// every non-empty PieceType fits in three bits, so those are folded down first
+template <int N>
+constexpr std::uint16_t BasicChessboard<N>::gatherNibbles(std::uint64_t nibbles) {
+  std::uint64_t x = (nibbles | (nibbles >> 1) | (nibbles >> 2)) &
+                    0x1111111111111111ULL;
+  x = (x | (x >> 3)) & 0x0303030303030303ULL;
+  x = (x | (x >> 6)) & 0x000F000F000F000FULL;
+  x = (x | (x >> 12)) & 0x000000FF000000FFULL;
+  return static_cast<std::uint16_t>(x | (x >> 24));
+}
 
-  // takes an int representing the level the user is on in Solitaire Chess
-  // returns vector of ints representing the list of piece IDs in order of the
-  // arrangement of pieces at the start of the given level
-  std::array<PieceType::PieceType, 16> getLevelOutline(int level);
+// the levels and the renderer are 4x4, so only the 4x4 board has these
+template <>
+BasicChessboard<4>::BasicChessboard(int level, const LevelPack& pack);
+template <>
+void BasicChessboard<4>::printBoard(std::ostream& out) const;
+
+// every size is compiled once, in chessboard.cpp
+extern template class BasicChessboard<4>;
+extern template class BasicChessboard<5>;
+extern template class BasicChessboard<6>;
+extern template class BasicChessboard<7>;
+extern template class BasicChessboard<8>;
+
+namespace {
+  // returns the index of the lowest set bit of a non-zero mask
+  int lowestSquare(std::uint64_t mask);
 }
 
 #endif
@@ -0,0 +1,48 @@
+// a solver that runs while the game is compiled, for checking built-in boards
+#ifndef CONSTEXPR_SOLVER_H
+#define CONSTEXPR_SOLVER_H
+
+#include <cstdint>
+
+#include "attack-tables.hpp"
+#include "chessboard.hpp"
+#include "piece-type-enum.hpp"
+
+/* Everything here is constexpr, so a board can be proven solvable with a
+ * static_assert and a broken one fails the build instead of reaching a
+ * player. It is the plain depth-first search, on packed positions and the
+ * attack tables, without the Solver's transposition table, tablebase or
+ * move ordering: fine for the few thousand positions of a hand-made level,
+ * far too slow for anything the Solver is used for at run time.
+ */
+namespace ConstexprSolver {
+  // returns the packed 4x4 position after the piece on 'from' captures the
+  // one on 'to'
+  constexpr std::uint64_t capture(std::uint64_t packed, int from, int to) {
+    const std::uint64_t mover = (packed >> (4 * from)) & 0xF;
+    packed &= ~((0xFULL << (4 * from)) | (0xFULL << (4 * to)));
+    return packed | (mover << (4 * to));
+  }
+
+  // returns true if some sequence of captures leaves exactly one piece on
+  // the packed 4x4 position 'packed'
+  constexpr bool isSolvable(std::uint64_t packed) {
+    const Attacks::Mask occ = Chessboard::occupancyOf(packed);
+    if ((occ & (occ - 1)) == 0) {
+      return occ != 0;
+    }
+    for (Attacks::Mask pieces = occ; pieces != 0; pieces &= pieces - 1) {
+      const int from = __builtin_ctz(pieces);
+      const auto piece_type = static_cast<PieceType::PieceType>((packed >> (4 * from)) & 0xF);
+      for (Attacks::Mask captures = Attacks::captures(piece_type, from, occ); captures != 0;
+           captures &= captures - 1) {
+        if (isSolvable(capture(packed, from, __builtin_ctz(captures)))) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+}
+
+#endif
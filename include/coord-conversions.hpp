@@ -1,3 +1,6 @@
+#ifndef COORD_CONVERSIONS_H
+#define COORD_CONVERSIONS_H
+
 #include <string>
 #include <utility>
 
@@ -13,4 +16,31 @@ namespace Coords {
 
   // converts index to two-digit coordinate
   std::pair<int, int> indexToCoord(int index);
+
+  // converts two-digit coordinate to index (0-15, left-to-right, top-to-bottom)
+  int coordToIndex(const std::pair<int, int>& coord);
+
+  // the same conversions on an N x N board, where rows run 1-N from the
+  // bottom up and columns 1-N from the left; the functions above are these
+  // with N = 4
+
+  // returns true if 'coord' is on the N x N board
+  template <int N>
+  constexpr bool coordExists(std::pair<int, int> coord) {
+    return coord.first >= 1 && coord.first <= N && coord.second >= 1 && coord.second <= N;
+  }
+
+  // converts index (0 to N*N-1) to two-digit coordinate
+  template <int N>
+  constexpr std::pair<int, int> indexToCoord(int index) {
+    return {N - index / N, 1 + index % N};
+  }
+
+  // converts two-digit coordinate to index (left-to-right, top-to-bottom)
+  template <int N>
+  constexpr int coordToIndex(const std::pair<int, int>& coord) {
+    return N * (N - coord.first) + (coord.second - 1);
+  }
 }
+
+#endif
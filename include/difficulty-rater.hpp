@@ -0,0 +1,104 @@
+// (non-) member functions of DifficultyRater class forward declared here
+#ifndef DIFFICULTY_RATER_H
+#define DIFFICULTY_RATER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "chessboard.hpp"
+
+// rates how hard a board is by walking its whole capture tree: every
+// sequence of captures, until one piece is left (a solution) or none can
+// capture (a dead end)
+// a position's figures only depend on the position, so they're remembered
+// (in canonical form, see Symmetry) and every later tree that reaches it,
+// from the same board or another one, adds them up instead of walking it
+// again; rating a stream of generated boards gets faster as it goes
+class DifficultyRater {
+  public:
+    // the level groups of the level select screen
+    enum class Grade {
+      EASY,
+      INTERMEDIATE,
+      ADVANCED,
+      EXPERT,
+      UNSOLVABLE
+    };
+
+    struct Rating {
+      // positions in the capture tree, the board itself included (a
+      // position reached by two orders of captures is counted twice);
+      // counts stop at UINT64_MAX
+      std::uint64_t tree_size;
+      // capture sequences ending with one piece / with more than one piece
+      // and no capture left
+      std::uint64_t solutions;
+      std::uint64_t dead_ends;
+      // captures per position that has any, over the whole tree
+      double branching;
+      // dead ends per solution (infinite if there's no solution)
+      double dead_end_ratio;
+      // captures a player can make, playing only captures that still win,
+      // before one that loses becomes possible; the number of captures
+      // needed if no capture ever loses, 0 if the board can't be won
+      int first_mistake;
+      // chance that captures picked at random (uniformly, at every step)
+      // solve the board
+      double random_win_chance;
+      // -log2(random_win_chance): how many coin flips' worth of luck random
+      // play needs (infinite if the board can't be won); 'grade' is read
+      // off it
+      double score;
+      Grade grade;
+    };
+
+    // 'kilobytes' is the memory budget of the table of remembered positions
+    DifficultyRater(std::size_t kilobytes = 16 * 1024);
+
+    // returns the rating of 'board'
+    Rating rate(const Chessboard& board);
+
+    // returns the name of 'grade' ("easy", "intermediate", ...)
+    static const char* gradeName(Grade grade);
+
+    // returns the number of positions walked (not looked up) so far
+    std::uint64_t getNodes() const;
+
+  private:
+    // everything about the tree below one position
+    struct Subtree {
+      std::uint64_t size;
+      // positions in the tree with at least one capture, and their captures
+      std::uint64_t inner;
+      std::uint64_t captures;
+      std::uint64_t solutions;
+      std::uint64_t dead_ends;
+      double win_chance;
+      // captures until a losing one is possible (see Rating::first_mistake)
+      std::uint8_t first_mistake;
+    };
+
+    struct Slot {
+      // canonical packed position; 0 marks an unused slot
+      std::uint64_t key;
+      Subtree subtree;
+    };
+
+    // returns the figures for the tree below 'board', from the table if
+    // they're there
+    Subtree walk(const Chessboard& board);
+
+    // one slot per position, picked by its hash; a new position always
+    // replaces the old one
+    std::vector<Slot> slots_;
+    std::uint64_t mask_;
+    std::uint64_t nodes_{0};
+};
+
+namespace {
+  // returns a + b, or UINT64_MAX if that doesn't fit
+  std::uint64_t addCapped(std::uint64_t a, std::uint64_t b);
+}
+
+#endif
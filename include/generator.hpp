@@ -0,0 +1,92 @@
+// (non-) member functions of Generator class forward declared here
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "chessboard.hpp"
+#include "solution-counter.hpp"
+#include "solver.hpp"
+#include "tablebase.hpp"
+#include "transposition-table.hpp"
+
+// a batch puzzle generator: walks through (or randomly samples) piece
+// placements on the 4x4 board, keeps the solvable ones and streams them out,
+// one board per line in Notation
+// a board and its mirror image (or, without pawns, any turn or flip of it)
+// play the same, so only one of each such group is ever checked
+// in retrograde mode boards are instead built backwards from a single piece
+// by un-doing captures, so every one is solvable by construction
+// with 'unique' only boards with exactly one solution are kept
+class Generator {
+  public:
+    struct Options {
+      // pieces on every board
+      int pieces{4};
+      // piece letters (P, R, N, B, Q, K) the boards are made of; with
+      // 'exact_mix' every board holds exactly these pieces, otherwise each
+      // piece is any one of the letters
+      std::string mix{"PRNBQK"};
+      bool exact_mix{false};
+      // random boards to try; 0 walks through every placement instead
+      // (in retrograde mode, the number of boards to build, default 1000)
+      std::uint64_t samples{0};
+      bool retrograde{false};
+      // keeps only boards that exactly one sequence of captures solves
+      bool unique{false};
+      std::uint64_t seed{1};
+      // stop after this many solvable boards; 0 means no limit
+      std::uint64_t limit{0};
+      // memory budget of the solver's transposition table
+      std::size_t table_megabytes{64};
+    };
+
+    Generator(const Options& options);
+
+    // lets the solver answer boards small enough for 'tablebase' from it
+    void setTablebase(const Tablebase* tablebase);
+
+    // writes every solvable (or, with 'unique', uniquely solvable) board
+    // found to 'out'
+    // returns the number of boards written
+    std::uint64_t run(std::ostream& out);
+
+    // returns the number of boards that were checked by the solver
+    std::uint64_t getCandidates() const;
+    // returns the number of boards skipped as symmetric images of another
+    std::uint64_t getDuplicates() const;
+
+  private:
+    // checks one placement; 'squares' holds one bit per piece and 'types'
+    // the piece types to put on them, in square order
+    // returns false once the limit has been reached
+    bool consider(std::uint16_t squares, const PieceType::PieceType* types);
+    // returns true if 'packed' is a board to keep: solvable, and with
+    // 'unique', solvable only one way
+    bool keep(std::uint64_t packed);
+    void enumerate();
+    void sample();
+    void retrograde();
+    // writes one board out, unless it (or one of its symmetric images) has
+    // been seen
+    void emit(std::uint64_t packed, std::unordered_set<std::uint64_t>& seen);
+    void flush(bool force);
+
+    Options options_;
+    // piece types from the mix, sorted
+    std::vector<PieceType::PieceType> types_;
+    TranspositionTable table_;
+    Solver solver_;
+    SolutionCounter counter_;
+    std::ostream* out_{nullptr};
+    std::string buffer_;
+    std::uint64_t candidates_{0};
+    std::uint64_t duplicates_{0};
+    std::uint64_t found_{0};
+};
+
+#endif
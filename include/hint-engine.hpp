@@ -0,0 +1,52 @@
+// (non-) member functions of HintEngine class forward declared here
+#ifndef HINT_ENGINE_H
+#define HINT_ENGINE_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "chessboard.hpp"
+#include "move.hpp"
+#include "solver.hpp"
+#include "tablebase.hpp"
+#include "transposition-table.hpp"
+
+// answers "what should I capture next?" for the position a player is in,
+// within a fixed time budget
+// the whole winning line is kept once found, so later hints along it (the
+// player following the advice) cost a lookup; positions small enough for the
+// tablebase are answered from it
+class HintEngine {
+  public:
+    enum class Status {
+      WINNING,     // 'move' is a capture that still wins
+      SOLVED,      // one piece left, nothing to do
+      UNSOLVABLE,  // no sequence of captures wins from here any more
+      TIMEOUT      // the budget ran out before the search settled
+    };
+
+    struct Hint {
+      Status status;
+      Move move;
+    };
+
+    HintEngine(std::chrono::microseconds budget = std::chrono::milliseconds(1));
+
+    // answers positions small enough for 'tablebase' straight from it
+    void setTablebase(const Tablebase* tablebase);
+
+    // returns a winning capture for 'board', or why there is none
+    Hint hint(const Chessboard& board);
+
+  private:
+    std::chrono::microseconds budget_;
+    TranspositionTable table_;
+    Solver solver_;
+    // the last winning line found and the position before each of its moves
+    std::array<Move, 15> line_{};
+    std::array<std::uint64_t, 15> positions_{};
+    int line_size_{0};
+};
+
+#endif
@@ -0,0 +1,81 @@
+// (non-) member functions of LevelPack class forward declared here
+#ifndef LEVEL_PACK_H
+#define LEVEL_PACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* A set of levels, each stored as its packed board (see
+ * Chessboard::getPacked), so a level is one 8-byte record that needs no
+ * parsing to become a board.
+ *
+ * File layout:
+ *   Header (16 bytes)
+ *   level numbers, uint32 each, ascending
+ *   zero padding up to a multiple of 8 bytes
+ *   records, uint64 each, in the same order as the level numbers
+ *
+ * A file is memory-mapped and used in place. The levels that ship with the
+ * game are the built-in pack, laid out the same way in the binary itself.
+ */
+class LevelPack {
+  public:
+    struct Header {
+      char magic[4];  // "SCLP"
+      std::uint32_t version;
+      std::uint32_t count;
+      std::uint32_t reserved;
+    };
+
+    LevelPack() = default;
+    ~LevelPack();
+    LevelPack(const LevelPack&) = delete;
+    LevelPack& operator=(const LevelPack&) = delete;
+
+    // returns the pack of the levels that ship with the game (0 being the
+    // tutorial's example, 1-20 the levels)
+    static const LevelPack& builtin();
+
+    // writes 'levels' (level number, packed board) as a pack file at 'path';
+    // returns false if the file couldn't be written
+    static bool write(std::vector<std::pair<std::uint32_t, std::uint64_t>> levels,
+                      const std::string& path);
+
+    // memory-maps the pack file at 'path'; returns false (leaving the pack
+    // empty) if it's missing or malformed
+    bool open(const std::string& path);
+    void close();
+
+    // returns the number of levels in the pack
+    std::uint32_t size() const;
+    // returns the level number and record of the i-th level, in order
+    std::uint32_t levelAt(std::uint32_t i) const;
+    std::uint64_t recordAt(std::uint32_t i) const;
+    // returns the record of level 'level', or nullptr if it's not in the pack
+    const std::uint64_t* find(std::uint32_t level) const;
+
+  private:
+    LevelPack(const std::uint32_t* levels, const std::uint64_t* records,
+              std::uint32_t count);
+
+    const std::uint32_t* levels_{nullptr};
+    const std::uint64_t* records_{nullptr};
+    std::uint32_t count_{0};
+    // the mapped file, if the pack came from one
+    void* mapping_{nullptr};
+    std::size_t size_{0};
+};
+
+namespace {
+  // returns the byte offset of the records in a pack of 'count' levels
+  std::size_t recordsOffset(std::uint32_t count);
+  // returns true if 'levels' is strictly ascending and every square of
+  // every record holds EMPTY or a piece type
+  bool validContents(const std::uint32_t* levels, const std::uint64_t* records,
+                     std::uint32_t count);
+}
+
+#endif
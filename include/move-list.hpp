@@ -0,0 +1,37 @@
+#ifndef MOVE_LIST_H
+#define MOVE_LIST_H
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include "move.hpp"
+
+// a fixed-capacity list of captures that lives on the stack, so generating
+// moves never touches the heap
+// each board size lists its moves in one sized for every capture on its
+// board at once (see BoardTraits::kMaxCaptures)
+template <int Capacity>
+class BasicMoveList {
+  public:
+    static constexpr int kCapacity{Capacity};
+
+    void push(const Move& move) { moves_[size_++] = move; }
+    void clear() { size_ = 0; }
+
+    int size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const Move& operator[](int index) const { return moves_[index]; }
+    const Move* begin() const { return moves_.data(); }
+    const Move* end() const { return moves_.data() + size_; }
+
+  private:
+    std::array<Move, kCapacity> moves_;
+    std::conditional_t<(kCapacity < 256), std::uint8_t, std::uint16_t> size_{0};
+};
+
+// the list of the 4x4 board: no piece can capture more than 8 others, so
+// 16 pieces * 8 is enough for every capture on the board at once
+using MoveList = BasicMoveList<128>;
+
+#endif
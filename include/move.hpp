@@ -0,0 +1,17 @@
+#ifndef MOVE_H
+#define MOVE_H
+
+#include <cstdint>
+#include <string>
+
+// a single capture: the piece on square 'from' takes the piece on square 'to'
+// (squares are board indices 0-15, left-to-right, top-to-bottom)
+struct Move {
+  std::uint8_t from;
+  std::uint8_t to;
+};
+
+// converts a move to "1A-2B" format
+std::string moveToDisplay(const Move& move);
+
+#endif
@@ -0,0 +1,90 @@
+// non-member functions of the Notation namespace and the PositionReader
+// class forward declared here
+#ifndef NOTATION_H
+#define NOTATION_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "piece-type-enum.hpp"
+
+/* A one-line text notation for positions, modelled on chess FEN: the four
+ * ranks from 4 down to 1, separated by '/', each listing its squares from
+ * A to D as a piece letter (P, R, N, B, Q, K) or a digit counting empty
+ * squares, e.g. "2R1/QP2/N3/4". A '.' also stands for one empty square,
+ * and lowercase letters are accepted. Anything after the position, past a
+ * space, is ignored, so files can carry extra fields.
+ *
+ * Positions are read and written as packed boards (see
+ * Chessboard::getPacked), without allocating.
+ */
+namespace Notation {
+  // the longest position text, "PPPP/PPPP/PPPP/PPPP"
+  constexpr std::size_t kMaxLength{19};
+
+  // the letter of each piece type ('.' for EMPTY)
+  constexpr std::array<char, 7> kLetters{'.', 'P', 'R', 'N', 'B', 'Q', 'K'};
+
+  // returns the letter of 'piece_type'
+  char typeToLetter(PieceType::PieceType piece_type);
+  // returns the piece type written as 'letter' (either case), or -1 if it
+  // isn't a piece letter
+  int letterToType(char letter);
+
+  // reads the position at the start of 'text' into 'packed'; returns false
+  // (leaving 'packed' alone) if it isn't a valid position
+  bool parse(std::string_view text, std::uint64_t& packed);
+  // writes the position 'packed' to 'out' (at least kMaxLength chars, not
+  // null-terminated); returns the number of characters written
+  std::size_t write(std::uint64_t packed, char* out);
+  // appends the position 'packed' to 'out'
+  void append(std::uint64_t packed, std::string& out);
+  // returns the position 'packed' as text
+  std::string toString(std::uint64_t packed);
+}
+
+// streams positions out of a file (or stdin), one per line, reading it in
+// large blocks straight from the file descriptor
+// blank lines and lines starting with '#' are skipped; lines that aren't
+// positions are skipped and counted
+class PositionReader {
+  public:
+    // reads from stdin
+    PositionReader();
+    ~PositionReader();
+    PositionReader(const PositionReader&) = delete;
+    PositionReader& operator=(const PositionReader&) = delete;
+
+    // reads from the file at 'path' ("-" meaning stdin); returns false if it
+    // can't be opened
+    bool open(const std::string& path);
+
+    // reads the next position into 'packed'; returns false at the end
+    bool next(std::uint64_t& packed);
+
+    // returns the number of the line the last position came from (from 1)
+    std::uint64_t getLine() const;
+    // returns the number of lines skipped as invalid
+    std::uint64_t getErrors() const;
+
+  private:
+    // moves the unread bytes to the front of the buffer and reads more,
+    // until it holds a whole line or the file is exhausted
+    void refill();
+
+    int fd_{0};
+    std::vector<char> buffer_;
+    std::size_t begin_{0};
+    std::size_t end_{0};
+    bool eof_{false};
+    // true while dropping the rest of a line too long for the buffer
+    bool skipping_{false};
+    std::uint64_t line_{0};
+    std::uint64_t errors_{0};
+};
+
+#endif
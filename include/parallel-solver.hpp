@@ -0,0 +1,82 @@
+// (non-) member functions of ParallelSolver class forward declared here
+#ifndef PARALLEL_SOLVER_H
+#define PARALLEL_SOLVER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "chessboard.hpp"
+#include "move.hpp"
+
+// a solver that spreads the capture tree over several threads
+// the first few plies below the root are split into tasks that idle threads
+// steal from each other; below that each thread searches depth-first, and all
+// threads share one lock-free table of positions proven unsolvable
+// as soon as one thread finds a solution, every other thread stops
+class ParallelSolver {
+  public:
+    // 'threads' == 0 uses every hardware thread; the table of dead positions
+    // holds 2^'table_bits' entries
+    ParallelSolver(unsigned threads = 0, int table_bits = 20);
+
+    // returns the captures that solve 'board', in order, or std::nullopt if
+    // the board can't be solved
+    std::optional<std::vector<Move>> solve(const Chessboard& board);
+
+    // returns the number of positions visited by all threads since the
+    // ParallelSolver was created
+    std::uint64_t getNodes() const;
+    unsigned getThreads() const;
+
+  private:
+    // one node of the capture tree still waiting to be searched, with the
+    // captures that led to it from the root
+    struct Task {
+      Chessboard board;
+      std::array<Move, 15> line;
+      std::uint8_t depth;
+    };
+
+    // a worker's own tasks; the owner takes from the back, thieves from the
+    // front (where the biggest subtrees are)
+    struct WorkQueue {
+      std::mutex mutex;
+      std::deque<Task> tasks;
+    };
+
+    void work(unsigned id);
+    bool popTask(unsigned id, Task& task);
+    void pushTask(unsigned id, const Task& task);
+    // searches 'task' to the end on this thread; returns true if it's solved
+    bool search(Task& task, std::uint64_t& nodes);
+    void publish(const Task& task);
+
+    bool isDead(const Chessboard& board) const;
+    void markDead(const Chessboard& board);
+
+    unsigned threads_;
+    // plies from the root that are split into stealable tasks
+    int split_depth_{3};
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    // packed positions proven unsolvable; 0 marks an empty slot
+    std::unique_ptr<std::atomic<std::uint64_t>[]> dead_;
+    std::uint64_t dead_mask_;
+    int dead_shift_;
+
+    // tasks pushed but not yet finished
+    std::atomic<std::int64_t> pending_{0};
+    std::atomic<bool> found_{false};
+    std::atomic<std::uint64_t> nodes_{0};
+    std::mutex solution_mutex_;
+    std::vector<Move> solution_;
+};
+
+#endif
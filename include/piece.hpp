@@ -3,38 +3,33 @@
 #define PIECE_H
 
 #include <array>
-#include <string>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
 #include <utility>
-#include <vector>
 
 #include "piece-type-enum.hpp"
 
 // a class with the properties of each chess piece
+// the name and image of each piece type are stored once, in read-only tables,
+// so a Piece is only its type and position (trivially copyable, 3 bytes)
 class Piece {
   public:
     Piece() = default;
     Piece(PieceType::PieceType piece_type, const std::pair<int, int>& position);
 
-    const PieceType::PieceType& getPieceType() const;
-    const std::string& getName() const;
+    PieceType::PieceType getPieceType() const;
+    std::string_view getName() const;
     void setPosition(const std::pair<int, int>& position);
-    const std::pair<int, int>& getPosition() const;
-    const std::array<std::string, 7>& getImage() const;
+    std::pair<int, int> getPosition() const;
+    const std::array<std::string_view, 7>& getImage() const;
 
   private:
-    PieceType::PieceType piece_type_;
-    std::pair<int, int> position_;
-    std::string name_;
-    std::array<std::string, 7> image_;
+    std::uint8_t piece_type_{PieceType::EMPTY};
+    std::int8_t rank_{0};
+    std::int8_t file_{0};
 };
 
-namespace {
-  // returns name based on piece ID
-  std::string createName(PieceType::PieceType piece_type);
-
-  // takes piece ID
-  // returns vector of std::string's representing image of chess piece
-  std::array<std::string, 7> createImage(PieceType::PieceType piece_type);
-}
+static_assert(std::is_trivially_copyable_v<Piece>, "Piece must stay a flyweight");
 
 #endif
@@ -0,0 +1,100 @@
+// (non-) member functions of PuzzleServer class forward declared here
+#ifndef PUZZLE_SERVER_H
+#define PUZZLE_SERVER_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "chessboard.hpp"
+#include "level-pack.hpp"
+#include "move.hpp"
+#include "tablebase.hpp"
+
+/* A long-running service that answers puzzle requests over a Unix domain
+ * socket, so other tools can use the solver without starting a process per
+ * request. Every request is one line, and gets one line back:
+ *
+ *   SOLVE <board>               SOLVED 3D-2B 3B-2B ...  |  UNSOLVABLE  |  TIMEOUT
+ *   VALIDATE <level> <move> ... as --batch prints it, e.g. "3 SOLVED 2"
+ *   HINT <board>                HINT 2B-4C  |  SOLVED  |  UNSOLVABLE  |  TIMEOUT
+ *   LEVEL <level>               LEVEL 3 2R1/QP2/N3/4
+ *
+ * where <board> is a level number or a position in Notation. A request that
+ * can't be read gets "ERROR <reason>", and SOLVE and HINT give up with
+ * "TIMEOUT" after a millisecond of searching. A client may send many requests
+ * without waiting; replies come back in order.
+ *
+ * Connections are served by a pool of threads that all wait on one epoll
+ * set. A connection is only ever handed to one thread at a time, which
+ * answers every complete request it has sent and then hands it back. No
+ * thread ever waits on a client: replies a client isn't taking are queued,
+ * and nothing more is read from it until it has taken them. Each
+ * thread keeps its own solver and hint engine; the level pack and the
+ * tablebase are shared, read-only.
+ */
+class PuzzleServer {
+  public:
+    // 'threads' of 0 means one per hardware thread
+    PuzzleServer(const LevelPack& level_pack, const Tablebase& tablebase,
+                 unsigned threads = 0);
+    ~PuzzleServer();
+    PuzzleServer(const PuzzleServer&) = delete;
+    PuzzleServer& operator=(const PuzzleServer&) = delete;
+
+    // starts listening on the socket file at 'path' (replacing a stale one);
+    // returns false if that isn't possible
+    bool listen(const std::string& path);
+    // serves connections until stop() is called
+    void run();
+    // makes run() return once every thread has finished the request it's on
+    // (async-signal-safe, so it can be called from a signal handler)
+    void stop();
+
+  private:
+    // a connected client, the part of its last read that isn't a whole
+    // request yet and the replies it hasn't taken yet
+    struct Connection;
+    // one thread's tools; each thread makes its own
+    struct Worker;
+
+    // waits for and serves connections until stopped
+    void serve();
+    // accepts every pending connection
+    void acceptAll();
+    // reads what 'connection' has sent and answers every complete request;
+    // returns the events to wait for on it next, or 0 once it should be
+    // closed
+    std::uint32_t serveConnection(Connection& connection, Worker& worker);
+    // sends as much of 'connection's unsent replies as the socket takes
+    // without waiting; returns false if the client has gone
+    bool flush(Connection& connection);
+    // appends the answer to one request line to 'out'
+    void answer(std::string_view request, Worker& worker, std::string& out) const;
+    // reads a level number or a position into 'board'; returns false if
+    // 'text' is neither
+    bool parseBoard(std::string_view text, Chessboard& board) const;
+
+    const LevelPack& level_pack_;
+    const Tablebase& tablebase_;
+    unsigned threads_;
+    std::string path_;
+    int listen_fd_{-1};
+    int epoll_fd_{-1};
+    // becomes readable (and stays so) once stop() is called
+    int stop_fd_{-1};
+    // every open connection, by file descriptor, so the ones still open
+    // when the server stops can be closed
+    std::mutex connections_mutex_;
+    std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+};
+
+namespace {
+  // appends 'move' to 'out' in "1A-2B" format
+  void appendMove(const Move& move, std::string& out);
+}
+
+#endif
@@ -0,0 +1,57 @@
+// non-member functions of the Replay namespace forward declared here
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <string>
+#include <string_view>
+
+#include "chessboard.hpp"
+#include "level-pack.hpp"
+#include "move.hpp"
+
+/* Checks recorded games without any prompts. A game is one line:
+ *
+ *   <level> <move> <move> ...     e.g. "3 2B-4C 4C-3D"
+ *
+ * with moves in the same "1A-2B" format moveToDisplay writes (either letter
+ * case). Every move must be a capture the piece could make at that point.
+ * Parsing works on string_views, so checking a game never allocates.
+ */
+namespace Replay {
+  enum class Status {
+    SOLVED,      // every move was legal and one piece is left
+    INCOMPLETE,  // every move was legal but more than one piece is left
+    ILLEGAL,     // a move wasn't a legal capture
+    INVALID      // the line couldn't be read, or names no level
+  };
+
+  struct Result {
+    Status status;
+    int level;
+    // moves that were legal (for ILLEGAL, the bad one is the next)
+    int moves_played;
+    int pieces_left;
+    // the illegal move's text, pointing into the checked line
+    std::string_view bad_move;
+  };
+
+  // returns the square index (0-15) written as e.g. "2B", or -1
+  int parseSquare(std::string_view text);
+  // reads a move written as e.g. "2B-4C" into 'move'; returns false if
+  // 'text' isn't one
+  bool parseMove(std::string_view text, Move& move);
+
+  // plays the space-separated 'moves' from 'start'
+  Result validate(const Chessboard& start, std::string_view moves);
+  // checks one game line, "<level> <move> ...", with the level taken from
+  // 'pack'
+  Result validateLine(std::string_view line,
+                      const LevelPack& pack = LevelPack::builtin());
+
+  // appends a one-line description of 'result' (with a trailing newline):
+  //   "<level> SOLVED <moves>", "<level> INCOMPLETE <pieces left>",
+  //   "<level> ILLEGAL <move number> <move>" or "- INVALID"
+  void appendResult(const Result& result, std::string& out);
+}
+
+#endif
@@ -0,0 +1,56 @@
+// (non-) member functions of SolutionCounter class forward declared here
+#ifndef SOLUTION_COUNTER_H
+#define SOLUTION_COUNTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "chessboard.hpp"
+#include "tablebase.hpp"
+#include "transposition-table.hpp"
+
+// counts the distinct sequences of captures that solve a board
+// a board's count is the sum of the counts of the boards its captures lead
+// to, and every count worked out is remembered (big pawnless boards in
+// canonical form, see TranspositionTable::symmetricKey, since a board's images
+// have as many solutions as it does), so a position reached along many lines
+// is only ever walked once
+// with a limit the count stops as soon as it gets there, which makes "is
+// there exactly one solution?" about as cheap as "is there one?"
+class SolutionCounter {
+  public:
+    // counts are capped here (the table keeps 32 bits per count)
+    static constexpr std::uint64_t kMaxCount{UINT32_MAX};
+
+    // 'kilobytes' is the memory budget of the table of counts
+    SolutionCounter(std::size_t kilobytes = 16 * 1024);
+
+    // returns the number of capture sequences that solve 'board' (1 for a
+    // single piece, which is already solved)
+    std::uint64_t count(const Chessboard& board);
+    // returns the number of capture sequences that solve 'board', or 'limit'
+    // if there are at least that many
+    std::uint64_t countUpTo(const Chessboard& board, std::uint64_t limit);
+    // returns true if exactly one sequence of captures solves 'board'
+    bool isUnique(const Chessboard& board);
+
+    // skips boards small enough for 'tablebase' that it knows are unsolvable
+    // (nullptr or a closed tablebase turns that off)
+    void setTablebase(const Tablebase* tablebase);
+
+    // returns the number of positions visited since the counter was created
+    std::uint64_t getNodes() const;
+
+  private:
+    // returns the number of solutions of 'board', or 'limit' if there are at
+    // least that many
+    std::uint64_t search(const Chessboard& board, std::uint64_t limit);
+
+    // counts of positions already walked; an entry flagged LOWER_BOUND only
+    // says there are at least 'value' solutions
+    TranspositionTable table_;
+    const Tablebase* tablebase_{nullptr};
+    std::uint64_t nodes_{0};
+};
+
+#endif
@@ -0,0 +1,64 @@
+// (non-) member functions of Solver class forward declared here
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "chessboard.hpp"
+#include "move.hpp"
+#include "tablebase.hpp"
+#include "transposition-table.hpp"
+
+// a depth-first solver that finds a sequence of captures leaving exactly one
+// piece on the board, or proves that there is none
+// every position it settles is remembered in a transposition table, so one
+// Solver (or several sharing a table) can be reused to check many boards
+class Solver {
+  public:
+    // 'table' is shared with the caller; without one the Solver makes its own
+    Solver(TranspositionTable* table = nullptr);
+
+    // returns the captures that solve 'board', in order, or std::nullopt if
+    // the board can't be solved
+    std::optional<std::vector<Move>> solve(const Chessboard& board);
+    // returns true if 'board' can be solved, without handing back the line
+    bool isSolvable(const Chessboard& board);
+
+    // answers boards small enough for 'tablebase' straight from it
+    // (nullptr or a closed tablebase turns that off)
+    void setTablebase(const Tablebase* tablebase);
+
+    // makes every search give up once 'deadline' has passed (the clock is
+    // checked every few hundred positions); a search that gave up reports
+    // the board as unsolvable, so check wasAborted() before believing it
+    void setDeadline(std::chrono::steady_clock::time_point deadline);
+    void clearDeadline();
+    // returns true if the last search gave up at the deadline
+    bool wasAborted() const;
+
+    // returns the number of positions visited since the Solver was created
+    std::uint64_t getNodes() const;
+
+  private:
+    // returns true if 'board' can be solved, appending the captures that
+    // solve it to 'line'
+    bool search(const Chessboard& board, std::vector<Move>& line);
+
+    std::unique_ptr<TranspositionTable> own_table_;
+    // positions already known to be solvable (with a winning capture) or
+    // unsolvable
+    TranspositionTable* table_;
+    const Tablebase* tablebase_{nullptr};
+    // reused by isSolvable so checking a board never allocates
+    std::vector<Move> scratch_line_;
+    std::uint64_t nodes_{0};
+    bool has_deadline_{false};
+    bool aborted_{false};
+    std::chrono::steady_clock::time_point deadline_;
+};
+
+#endif
@@ -0,0 +1,122 @@
+// non-member functions of the Stats namespace forward declared here
+#ifndef STATS_H
+#define STATS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include "piece-type-enum.hpp"
+
+/* Work counters for profiling real sessions: move generation, board updates
+ * and copies, solver nodes, transposition table hits and misses, and the
+ * wall time spent in each phase.
+ *
+ * They only exist in builds configured with -DSOLITAIRE_CHESS_STATS=ON;
+ * otherwise the STATS_* macros expand to nothing (their arguments aren't even
+ * evaluated) and the hot paths are exactly as without them. Each thread counts
+ * into its own block, so counting never contends; the blocks are only summed
+ * when a report is written.
+ */
+#ifndef SOLITAIRE_CHESS_STATS
+#define SOLITAIRE_CHESS_STATS 0
+#endif
+
+namespace Stats {
+  enum Counter {
+    GET_MOVES_CALLS,
+    // moves generated, per piece type, in PieceType order
+    MOVES_PAWN,
+    MOVES_ROOK,
+    MOVES_KNIGHT,
+    MOVES_BISHOP,
+    MOVES_QUEEN,
+    MOVES_KING,
+    UPDATE_BOARD_CALLS,
+    BOARD_COPIES,
+    SOLVER_NODES,
+    TABLE_HITS,
+    TABLE_MISSES,
+    kCounterCount
+  };
+
+  // phases can nest (a hint runs a solve), so their times can add up to
+  // more than the run took
+  enum Phase {
+    SOLVE,
+    GENERATE,
+    BUILD_TABLEBASE,
+    BATCH,
+    HINT,
+    kPhaseCount
+  };
+
+  constexpr bool kEnabled{SOLITAIRE_CHESS_STATS != 0};
+
+  // one thread's counts; only that thread ever writes them
+  struct Block {
+    std::array<std::atomic<std::uint64_t>, kCounterCount> counts{};
+    std::array<std::atomic<std::uint64_t>, kPhaseCount> phase_nanoseconds{};
+  };
+
+  // returns this thread's block, registering it on first use
+  Block& localBlock();
+
+  // returns the counter for moves of 'piece_type'
+  constexpr Counter movesOf(PieceType::PieceType piece_type) {
+    return static_cast<Counter>(MOVES_PAWN + piece_type - PieceType::PAWN);
+  }
+
+  // adds 'amount' to this thread's 'counter'
+  // a relaxed load and store rather than a read-modify-write: no other thread
+  // writes this block, and the reader only needs a recent value
+  inline void add(Counter counter, std::uint64_t amount) {
+    thread_local Block& block = localBlock();
+    std::atomic<std::uint64_t>& count = block.counts[counter];
+    count.store(count.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+  }
+
+  // adds the time between its construction and destruction to 'phase'
+  class ScopedPhase {
+    public:
+      explicit ScopedPhase(Phase phase);
+      ~ScopedPhase();
+      ScopedPhase(const ScopedPhase&) = delete;
+      ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+    private:
+      Phase phase_;
+      std::chrono::steady_clock::time_point start_;
+  };
+
+  // every thread's counts summed together
+  struct Snapshot {
+    std::array<std::uint64_t, kCounterCount> counts{};
+    std::array<std::uint64_t, kPhaseCount> phase_nanoseconds{};
+  };
+  Snapshot snapshot();
+
+  // writes 'snapshot' as an aligned table / as JSON
+  void writeTable(const Snapshot& snapshot, std::ostream& out);
+  void writeJson(const Snapshot& snapshot, std::ostream& out);
+}
+
+namespace {
+  // returns 'name' with spaces turned into underscores and brackets dropped
+  std::string jsonKey(const char* name);
+}
+
+#if SOLITAIRE_CHESS_STATS
+#define STATS_ADD(counter, amount) Stats::add(counter, amount)
+#define STATS_CONCAT_INNER(a, b) a##b
+#define STATS_CONCAT(a, b) STATS_CONCAT_INNER(a, b)
+#define STATS_PHASE(phase) const Stats::ScopedPhase STATS_CONCAT(stats_phase_, __LINE__){phase}
+#else
+#define STATS_ADD(counter, amount) ((void)0)
+#define STATS_PHASE(phase) ((void)0)
+#endif
+
+#endif
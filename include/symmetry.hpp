@@ -0,0 +1,188 @@
+// compile-time symmetry tables and canonical forms of 4x4 positions
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include <array>
+#include <cstdint>
+
+#include "move.hpp"
+
+/* Every piece but the pawn moves the same way on a board turned or flipped
+ * any of the 8 ways a square can be (the dihedral group of the square); a
+ * pawn only captures upward, so boards with pawns only keep the left-right
+ * mirror. Boards that are images of each other are won or lost together, by
+ * the images of the same captures.
+ *
+ * A transform is 3 bits, applied lowest-numbered last: TRANSPOSE swaps rows
+ * and columns, then FLIP turns the board upside down, then MIRROR swaps left
+ * and right. A board's canonical form is the smallest packed value among its
+ * images under every transform its pieces allow.
+ */
+namespace Symmetry {
+  enum Transform : std::uint8_t {
+    IDENTITY = 0,
+    MIRROR = 1,
+    FLIP = 2,
+    TRANSPOSE = 4
+  };
+  constexpr int kTransforms{8};
+
+  // returns the square 'square' lands on under 'transform'
+  constexpr int mapSquare(int transform, int square) {
+    int row = square / 4, col = square % 4;
+    if (transform & TRANSPOSE) {
+      const int swap = row;
+      row = col;
+      col = swap;
+    }
+    if (transform & FLIP) {
+      row = 3 - row;
+    }
+    if (transform & MIRROR) {
+      col = 3 - col;
+    }
+    return 4 * row + col;
+  }
+
+  // returns the transform that undoes 'transform'
+  constexpr int inverse(int transform) {
+    for (int candidate = 0; candidate < kTransforms; candidate++) {
+      if (mapSquare(candidate, mapSquare(transform, 1)) == 1 &&
+          mapSquare(candidate, mapSquare(transform, 4)) == 4) {
+        return candidate;
+      }
+    }
+    return IDENTITY;
+  }
+
+  // per transform, where each square lands and the transform undoing it
+  constexpr std::array<std::array<std::uint8_t, 16>, kTransforms> makeSquareTable() {
+    std::array<std::array<std::uint8_t, 16>, kTransforms> table{};
+    for (int transform = 0; transform < kTransforms; transform++) {
+      for (int square = 0; square < 16; square++) {
+        table[transform][square] = static_cast<std::uint8_t>(mapSquare(transform, square));
+      }
+    }
+    return table;
+  }
+  inline constexpr std::array<std::array<std::uint8_t, 16>, kTransforms> kSquares{
+      makeSquareTable()};
+
+  // returns 'move' as played on the board transformed by 'transform'
+  constexpr Move mapMove(int transform, Move move) {
+    return Move{kSquares[transform][move.from], kSquares[transform][move.to]};
+  }
+
+  // returns the packed position reflected left-to-right (the order of the
+  // four nibbles of each row reversed)
+  constexpr std::uint64_t mirror(std::uint64_t packed) {
+    packed = ((packed & 0x0F0F0F0F0F0F0F0FULL) << 4) | ((packed >> 4) & 0x0F0F0F0F0F0F0F0FULL);
+    return ((packed & 0x00FF00FF00FF00FFULL) << 8) | ((packed >> 8) & 0x00FF00FF00FF00FFULL);
+  }
+
+  // returns the packed position upside down (the order of its rows reversed)
+  constexpr std::uint64_t flip(std::uint64_t packed) {
+    packed = (packed << 32) | (packed >> 32);
+    return ((packed & 0x0000FFFF0000FFFFULL) << 16) | ((packed >> 16) & 0x0000FFFF0000FFFFULL);
+  }
+
+  // returns the packed position with rows and columns swapped, by swapping
+  // the off-diagonal nibble pairs and then the off-diagonal 2x2 blocks
+  constexpr std::uint64_t transpose(std::uint64_t packed) {
+    std::uint64_t swap = (packed ^ (packed >> 12)) & 0x0000F0F00000F0F0ULL;
+    packed ^= swap ^ (swap << 12);
+    swap = (packed ^ (packed >> 24)) & 0x00000000FF00FF00ULL;
+    return packed ^ swap ^ (swap << 24);
+  }
+
+  // returns the packed position transformed by 'transform'
+  constexpr std::uint64_t apply(int transform, std::uint64_t packed) {
+    if (transform & TRANSPOSE) {
+      packed = transpose(packed);
+    }
+    if (transform & FLIP) {
+      packed = flip(packed);
+    }
+    if (transform & MIRROR) {
+      packed = mirror(packed);
+    }
+    return packed;
+  }
+
+  // returns the square mask 'mask' (bit i for square i) transformed by
+  // 'transform', with the same steps as apply on one bit per square
+  constexpr std::uint16_t applyMask(int transform, std::uint16_t mask) {
+    unsigned bits = mask;
+    if (transform & TRANSPOSE) {
+      unsigned swap = (bits ^ (bits >> 3)) & 0x0A0A;
+      bits ^= swap ^ (swap << 3);
+      swap = (bits ^ (bits >> 6)) & 0x00CC;
+      bits ^= swap ^ (swap << 6);
+    }
+    if (transform & FLIP) {
+      bits = ((bits << 8) | (bits >> 8)) & 0xFFFF;
+      bits = ((bits & 0x0F0F) << 4) | ((bits >> 4) & 0x0F0F);
+    }
+    if (transform & MIRROR) {
+      bits = ((bits & 0x5555) << 1) | ((bits >> 1) & 0x5555);
+      bits = ((bits & 0x3333) << 2) | ((bits >> 2) & 0x3333);
+    }
+    return static_cast<std::uint16_t>(bits);
+  }
+
+  // returns true if any square of the packed position holds a pawn
+  // (a nibble of 'packed' XOR all-pawns is zero exactly where one is)
+  constexpr bool hasPawn(std::uint64_t packed) {
+    const std::uint64_t x = packed ^ 0x1111111111111111ULL;
+    return ((x - 0x1111111111111111ULL) & ~x & 0x8888888888888888ULL) != 0;
+  }
+
+  // returns the smaller of the packed positions 'a' and 'b' without a branch
+  // (which image is smallest is anybody's guess, so a branch would mispredict
+  // half the time); piece types fit in three bits, so both are below 2^63
+  // and the sign of their difference says which is smaller
+  constexpr std::uint64_t least(std::uint64_t a, std::uint64_t b) {
+    const std::uint64_t a_smaller =
+        static_cast<std::uint64_t>(static_cast<std::int64_t>(a - b) >> 63);
+    return b ^ ((a ^ b) & a_smaller);
+  }
+
+  // returns the canonical form of the packed position: the smaller of it
+  // and its mirror image if it has pawns, else the smallest of all 8 images
+  constexpr std::uint64_t canonical(std::uint64_t packed) {
+    const std::uint64_t mirrored = mirror(packed);
+    const std::uint64_t form = least(packed, mirrored);
+    if (hasPawn(packed)) {
+      return form;
+    }
+    const std::uint64_t transposed = transpose(packed), flipped = flip(transposed);
+    return least(least(form, least(flip(packed), flip(mirrored))),
+                 least(least(transposed, mirror(transposed)), least(flipped, mirror(flipped))));
+  }
+
+  // returns the transform taking the packed position to 'form', one of its
+  // images (e.g. its canonical form)
+  constexpr int transformTo(std::uint64_t packed, std::uint64_t form) {
+    for (int transform = 0; transform < kTransforms; transform++) {
+      if (apply(transform, packed) == form) {
+        return transform;
+      }
+    }
+    return IDENTITY;
+  }
+
+  // a board's canonical form and the transform taking the board to it
+  struct Canonical {
+    std::uint64_t packed;
+    std::uint8_t transform;
+  };
+
+  // returns the canonical form of the packed position and the transform
+  // taking the position to it
+  constexpr Canonical canonicalize(std::uint64_t packed) {
+    const std::uint64_t form = canonical(packed);
+    return {form, static_cast<std::uint8_t>(transformTo(packed, form))};
+  }
+}
+
+#endif
@@ -0,0 +1,98 @@
+// (non-) member functions of Tablebase class forward declared here
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "chessboard.hpp"
+#include "move.hpp"
+
+/* A precomputed answer for every 4x4 board of up to 'max pieces' pieces:
+ * one byte per board, either 0 (unsolvable), 0xFF (a single piece, already
+ * solved) or a winning capture packed as (from << 4) | to.
+ *
+ * Boards are grouped into layers by piece count. Inside a layer a board's
+ * index is the rank of its set of occupied squares among all sets of that
+ * size (combinatorial number system) times 6^pieces, plus its piece types
+ * (1-6, minus one) read as a base-6 number, lowest square first. The index
+ * is computed straight from the packed board, so a lookup is one load.
+ *
+ * Version 2 files only fill in the entries of boards in canonical form (see
+ * Symmetry), which is roughly half of them (an eighth without pawns); every
+ * board is looked up by its canonical form, and winning captures are stored
+ * as played on it. Version 1 files fill in every entry and read the same way.
+ *
+ * File layout: Header, then every layer's bytes back to back.
+ */
+class Tablebase {
+  public:
+    struct Header {
+      char magic[4];  // "SCTB"
+      std::uint32_t version;
+      std::uint32_t max_pieces;
+      std::uint32_t reserved;
+      // byte offset of each layer's first entry, from the start of the file
+      std::array<std::uint64_t, 17> layer_offsets;
+    };
+
+    // what the tablebase knows about one board
+    struct Probe {
+      // false if the board has more pieces than the tablebase covers
+      bool known;
+      bool solvable;
+      // a winning capture (only if solvable with more than one piece)
+      Move move;
+      // captures left to solve it (pieces - 1)
+      int captures_left;
+    };
+
+    Tablebase() = default;
+    ~Tablebase();
+    Tablebase(const Tablebase&) = delete;
+    Tablebase& operator=(const Tablebase&) = delete;
+
+    // computes the tablebase for boards of up to 'max_pieces' pieces and
+    // writes it to 'path'; returns false if the file couldn't be written
+    static bool build(int max_pieces, const std::string& path);
+
+    // memory-maps the tablebase file at 'path'; returns false (leaving the
+    // tablebase closed) if it's missing or malformed
+    bool open(const std::string& path);
+    // opens the file named by $SOLITAIRE_CHESS_TABLEBASE, or else
+    // "solitaire-chess.tb" in the working directory
+    bool openDefault();
+    void close();
+
+    bool isOpen() const;
+    int getMaxPieces() const;
+    Probe probe(const Chessboard& board) const;
+
+  private:
+    const std::uint8_t* data_{nullptr};
+    std::size_t size_{0};
+    int max_pieces_{0};
+    // copied out of the header when the file is opened
+    std::array<std::uint64_t, 17> layer_offsets_{};
+};
+
+namespace {
+  // calls 'visit(index, packed, occ)' for every board with 'pieces' pieces, in
+  // layer order
+  template <typename Visit>
+  void forEachBoard(int pieces, Visit visit);
+
+  // returns the index of a board with 'pieces' pieces inside its layer
+  std::uint64_t layerIndex(std::uint64_t packed, std::uint16_t occ, int pieces);
+
+  // returns the index of the canonical form (see Symmetry) of a board with
+  // 'pieces' pieces inside its layer
+  std::uint64_t canonicalIndex(std::uint64_t packed, int pieces);
+
+  // returns the number of boards with exactly 'pieces' pieces
+  std::uint64_t layerSize(int pieces);
+}
+
+#endif
@@ -0,0 +1,112 @@
+// (non-) member functions of TranspositionTable class forward declared here
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "chessboard.hpp"
+#include "move.hpp"
+#include "symmetry.hpp"
+#include "zobrist.hpp"
+
+// a fixed-size cache of results for positions that have already been
+// searched, shared by whatever tool is searching (solver, hints, ratings...)
+// entries are grouped into cache-line-sized buckets of four; a position can
+// only live in the bucket its Zobrist hash points to, and the full packed
+// position is stored so a hit is never a false positive
+class TranspositionTable {
+  public:
+    // what an entry says about its position
+    enum Flag : std::uint8_t {
+      UNSOLVABLE = 1,
+      SOLVABLE = 2,
+      // 'value' is only a lower bound (e.g. a count that stopped early)
+      LOWER_BOUND = 4
+    };
+
+    // which entry of a full bucket a new position evicts
+    enum class Replacement {
+      ALWAYS,          // the least recently stored entry
+      DEPTH_PREFERRED  // the entry with the fewest pieces (cheapest to redo)
+    };
+
+    struct Entry {
+      // packed position (Chessboard::getPacked); 0 marks an unused entry
+      std::uint64_t key;
+      // free for the tool that stored the entry (e.g. a solution count)
+      std::uint32_t value;
+      // best capture from this position, if any
+      Move move;
+      // pieces on the board; larger means the result was more work
+      std::uint8_t depth;
+      // Flag bits
+      std::uint8_t flags;
+    };
+
+    // a packed position to look up or store, with its Zobrist hash
+    struct Key {
+      std::uint64_t packed;
+      std::uint64_t hash;
+    };
+
+    // 'kilobytes' is the memory budget; the table uses the largest power of
+    // two number of buckets that fits in it
+    TranspositionTable(std::size_t kilobytes = 16 * 1024,
+                       Replacement replacement = Replacement::DEPTH_PREFERRED);
+
+    // returns the entry stored for 'board', or nullptr if there is none
+    const Entry* probe(const Chessboard& board) const;
+    // returns the entry stored for the packed position 'key', whose Zobrist
+    // hash is 'hash', or nullptr if there is none
+    const Entry* probe(std::uint64_t key, std::uint64_t hash) const;
+    // stores 'entry' for 'board', evicting another position if its bucket
+    // is full
+    void store(const Chessboard& board, Entry entry);
+    // stores 'entry' for the packed position 'key', whose Zobrist hash is
+    // 'hash', evicting another position if its bucket is full
+    void store(std::uint64_t key, std::uint64_t hash, Entry entry);
+    void clear();
+
+    // positions with fewer pieces than this are stored as they are, even by
+    // tools sharing results between symmetric images: their subtrees are
+    // cheaper to search again than canonicalizing every node is
+    static constexpr int kSymmetricPieces{8};
+
+    // returns the key 'board', holding 'pieces' pieces, is stored under by
+    // tools sharing results between symmetric images (see Symmetry): the
+    // canonical form of a pawnless board of kSymmetricPieces or more, else
+    // the board itself (a board with pawns could only share with its mirror
+    // image, which isn't worth the hashing); only a canonical form other than
+    // the board has its hash worked out from scratch
+    static Key symmetricKey(const Chessboard& board, int pieces) {
+      const std::uint64_t packed = board.getPacked();
+      if (pieces < kSymmetricPieces || Symmetry::hasPawn(packed)) {
+        return {packed, board.getHash()};
+      }
+      const std::uint64_t form = Symmetry::canonical(packed);
+      return {form, form == packed ? board.getHash() : Zobrist::hashPacked(form)};
+    }
+
+    std::size_t getCapacity() const;
+    std::uint64_t getHits() const;
+    std::uint64_t getMisses() const;
+
+  private:
+    struct alignas(64) Bucket {
+      std::array<Entry, 4> entries;
+    };
+
+    Bucket& bucketFor(std::uint64_t hash);
+    const Bucket& bucketFor(std::uint64_t hash) const;
+
+    std::vector<Bucket> buckets_;
+    std::uint64_t mask_;
+    Replacement replacement_;
+    mutable std::uint64_t hits_{0};
+    mutable std::uint64_t misses_{0};
+};
+
+#endif
@@ -0,0 +1,56 @@
+// compile-time Zobrist keys for hashing board positions
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <array>
+#include <cstdint>
+
+#include "piece-type-enum.hpp"
+
+/* A position's hash is the XOR of one random key per (piece type, square)
+ * pair on the board, so a capture only has to XOR out the mover's origin and
+ * the captured piece and XOR in the mover's destination. EMPTY's keys are all
+ * zero, which lets empty squares drop out of the hash for free.
+ */
+namespace Zobrist {
+  // returns the next value of a splitmix64 sequence, advancing 'state'
+  constexpr std::uint64_t splitMix(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+  // builds the keys of a board of 'Squares' squares; every size draws them
+  // from the same sequence, square by square within each piece type
+  template <int Squares>
+  constexpr std::array<std::array<std::uint64_t, Squares>, 7> makeKeys() {
+    std::array<std::array<std::uint64_t, Squares>, 7> keys{};
+    std::uint64_t state{0x5C5C5C5C5C5C5C5CULL};
+    for (int piece_type = PieceType::PAWN; piece_type <= PieceType::KING; piece_type++) {
+      for (int square = 0; square < Squares; square++) {
+        keys[piece_type][square] = splitMix(state);
+      }
+    }
+    return keys;
+  }
+
+  // one key per piece type and square of an N x N board; keys[EMPTY] is all
+  // zero
+  template <int N>
+  inline constexpr std::array<std::array<std::uint64_t, N * N>, 7> kBoardKeys{
+      makeKeys<N * N>()};
+  // the keys of the 4x4 board
+  inline constexpr const std::array<std::array<std::uint64_t, 16>, 7>& kKeys{kBoardKeys<4>};
+
+  // returns the hash of the position packed four bits per square
+  constexpr std::uint64_t hashPacked(std::uint64_t packed) {
+    std::uint64_t hash{0};
+    for (int square = 0; square < 16; square++) {
+      hash ^= kKeys[(packed >> (4 * square)) & 0xF][square];
+    }
+    return hash;
+  }
+}
+
+#endif
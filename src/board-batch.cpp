@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cstring>
+
+#include "../include/board-batch.hpp"
+#include "../include/piece-type-enum.hpp"
+
+// the kernel's helpers take and return 32-byte vectors by value; they're
+// always inlined into the AVX2 function, so the calling-convention change GCC
+// warns about never happens
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace {
+  // squares on each file (bit i is square i, so a file is every fourth bit)
+  constexpr unsigned kFileA{0x1111}, kFileB{0x2222}, kFileC{0x4444}, kFileD{0x8888};
+
+  // the kernel below is written once for a plain 16-bit mask and for GCC
+  // vectors of them, whose operators work lane by lane; 'mask16' keeps a
+  // scalar's promoted int within 16 bits and does nothing to a vector
+  template <typename T>
+  inline __attribute__((always_inline)) T mask16(T value) {
+    return value;
+  }
+  inline __attribute__((always_inline)) unsigned mask16(unsigned value) {
+    return value & 0xFFFF;
+  }
+
+  // returns 'mask' moved 'rows' down and 'cols' right (rows count down from
+  // the top, as in Attacks), dropping whatever leaves the board
+  template <int Rows, int Cols, typename T>
+  inline __attribute__((always_inline)) T step(T mask) {
+    // the columns a piece can't leave from in this direction
+    constexpr unsigned kBlocked = Cols == 1    ? kFileD
+                                  : Cols == 2  ? kFileC | kFileD
+                                  : Cols == -1 ? kFileA
+                                  : Cols == -2 ? kFileA | kFileB
+                                               : 0;
+    constexpr int kShift = 4 * Rows + Cols;
+    const T from = mask & (0xFFFF & ~kBlocked);
+    if constexpr (kShift >= 0) {
+      return mask16(from << kShift);
+    } else {
+      return from >> -kShift;
+    }
+  }
+
+  // returns the squares 'sliders' reach along one direction, up to and
+  // including the first piece of 'occ' (a 4x4 board has at most 3 steps)
+  template <int Rows, int Cols, typename T>
+  inline __attribute__((always_inline)) T slide(T sliders, T occ) {
+    T ray = step<Rows, Cols>(sliders);
+    T reached = ray;
+    ray = step<Rows, Cols>(ray & ~occ);
+    reached |= ray;
+    ray = step<Rows, Cols>(ray & ~occ);
+    return reached | ray;
+  }
+
+  // returns the squares any piece can capture, given one mask per piece type
+  template <typename T>
+  inline __attribute__((always_inline)) T targets(T pawns, T rooks, T knights,
+                                                  T bishops, T queens, T kings) {
+    const T occ = pawns | rooks | knights | bishops | queens | kings;
+    const T straight = rooks | queens, diagonal = bishops | queens;
+    // pawns only capture diagonally forward (up)
+    T attacks = step<-1, 1>(pawns) | step<-1, -1>(pawns);
+    attacks |= step<-2, 1>(knights) | step<-2, -1>(knights) | step<2, 1>(knights) |
+               step<2, -1>(knights) | step<1, 2>(knights) | step<-1, 2>(knights) |
+               step<1, -2>(knights) | step<-1, -2>(knights);
+    attacks |= step<-1, 0>(kings) | step<1, 0>(kings) | step<0, 1>(kings) |
+               step<0, -1>(kings) | step<-1, 1>(kings) | step<-1, -1>(kings) |
+               step<1, 1>(kings) | step<1, -1>(kings);
+    attacks |= slide<-1, 0>(straight, occ) | slide<1, 0>(straight, occ) |
+               slide<0, 1>(straight, occ) | slide<0, -1>(straight, occ);
+    attacks |= slide<-1, 1>(diagonal, occ) | slide<-1, -1>(diagonal, occ) |
+               slide<1, 1>(diagonal, occ) | slide<1, -1>(diagonal, occ);
+    return attacks & occ;
+  }
+
+  // one board per lane: 8 fill an SSE2 register, 16 an AVX2 one
+  typedef std::uint16_t Lanes8 __attribute__((vector_size(16)));
+  typedef std::uint16_t Lanes16 __attribute__((vector_size(32)));
+
+  // runs the kernel over 'count' boards (a multiple of the lanes in
+  // 'Vector'), one vector of boards at a time
+  template <typename Vector>
+  inline __attribute__((always_inline)) void vectorTargets(
+      const std::uint16_t* const* masks, std::uint16_t* out, std::size_t count) {
+    constexpr std::size_t kLanes = sizeof(Vector) / sizeof(std::uint16_t);
+    for (std::size_t i = 0; i < count; i += kLanes) {
+      // unaligned loads, one vector of boards per piece type
+      auto load = [i, masks](int type) {
+        Vector vector;
+        std::memcpy(&vector, masks[type] + i, sizeof(Vector));
+        return vector;
+      };
+      const Vector result = targets(load(0), load(1), load(2), load(3), load(4), load(5));
+      std::memcpy(out + i, &result, sizeof(Vector));
+    }
+  }
+
+  void scalarTargets(const std::uint16_t* const* masks, std::uint16_t* out,
+                     std::size_t count) {
+    for (std::size_t i = 0; i < count; i++) {
+      out[i] = static_cast<std::uint16_t>(
+          targets<unsigned>(masks[0][i], masks[1][i], masks[2][i], masks[3][i],
+                            masks[4][i], masks[5][i]));
+    }
+  }
+
+#if defined(__x86_64__) || defined(__i386__)
+  __attribute__((target("sse2"))) void sse2Targets(
+      const std::uint16_t* const* masks, std::uint16_t* out, std::size_t count) {
+    vectorTargets<Lanes8>(masks, out, count);
+  }
+
+  __attribute__((target("avx2"))) void avx2Targets(
+      const std::uint16_t* const* masks, std::uint16_t* out, std::size_t count) {
+    vectorTargets<Lanes16>(masks, out, count);
+  }
+#endif
+}
+
+
+/* MEMBER FUNCTIONS */
+
+// returns the fastest kernel this CPU supports
+BoardBatch::Kernel BoardBatch::bestKernel() {
+  static const Kernel best = supports(Kernel::AVX2)   ? Kernel::AVX2
+                             : supports(Kernel::SSE2) ? Kernel::SSE2
+                                                      : Kernel::SCALAR;
+  return best;
+}
+
+// returns true if this CPU can run 'kernel'
+bool BoardBatch::supports(Kernel kernel) {
+#if defined(__x86_64__) || defined(__i386__)
+  switch (kernel) {
+    case Kernel::AVX2:
+      return __builtin_cpu_supports("avx2");
+    case Kernel::SSE2:
+      return __builtin_cpu_supports("sse2");
+    default:
+      return true;
+  }
+#else
+  return kernel == Kernel::SCALAR;
+#endif
+}
+
+// adds the board whose packed position (see Chessboard::getPacked) is
+// 'packed'
+void BoardBatch::add(std::uint64_t packed) {
+  if (size_ % kBlock == 0) {
+    for (std::vector<std::uint16_t>& masks : masks_) {
+      masks.resize(size_ + kBlock, 0);
+    }
+  }
+  for (int square = 0; packed != 0; square++, packed >>= 4) {
+    if (const unsigned type = packed & 0xF; type >= PieceType::PAWN && type <= PieceType::KING) {
+      masks_[type - PieceType::PAWN][size_] |= static_cast<std::uint16_t>(1u << square);
+    }
+  }
+  size_++;
+}
+
+void BoardBatch::clear() {
+  for (std::vector<std::uint16_t>& masks : masks_) {
+    masks.clear();
+  }
+  size_ = 0;
+}
+
+// writes, for each board in the order they were added, a mask of the squares
+// some piece on it can capture, to 'out' (size() entries)
+void BoardBatch::captureTargets(std::uint16_t* out, Kernel kernel) const {
+  captureTargets(0, size_, out, kernel);
+}
+
+// writes the capture masks of the 'count' boards from board 'first' (a
+// multiple of kBlock) on to 'out'
+void BoardBatch::captureTargets(std::size_t first, std::size_t count, std::uint16_t* out,
+                                Kernel kernel) const {
+  const std::uint16_t* masks[6];
+  for (int type = 0; type < 6; type++) {
+    masks[type] = masks_[type].data() + first;
+  }
+  // whole blocks go straight to 'out'; the last, partial one goes through a
+  // scratch block so nothing is written past 'count' entries
+  const std::size_t whole = count - count % kBlock;
+  std::uint16_t tail[kBlock];
+  auto run = [kernel](const std::uint16_t* const* from, std::uint16_t* to, std::size_t boards) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (kernel == Kernel::AVX2 && supports(Kernel::AVX2)) {
+      avx2Targets(from, to, boards);
+      return;
+    }
+    if (kernel == Kernel::SSE2 && supports(Kernel::SSE2)) {
+      sse2Targets(from, to, boards);
+      return;
+    }
+#endif
+    scalarTargets(from, to, boards);
+  };
+  run(masks, out, whole);
+  if (whole != count) {
+    for (int type = 0; type < 6; type++) {
+      masks[type] += whole;
+    }
+    run(masks, tail, kBlock);
+    std::copy(tail, tail + (count - whole), out + whole);
+  }
+}
+
+// writes, for each board, 1 if any piece on it can capture, 0 otherwise
+void BoardBatch::hasMoves(std::uint8_t* out, Kernel kernel) const {
+  // goes through the masks in stack-sized slices, so there's no allocation
+  constexpr std::size_t kSlice{64 * kBlock};
+  std::uint16_t targets[kSlice];
+  for (std::size_t first = 0; first < size_; first += kSlice) {
+    const std::size_t count = std::min(kSlice, size_ - first);
+    captureTargets(first, count, targets, kernel);
+    for (std::size_t i = 0; i < count; i++) {
+      out[first + i] = targets[i] != 0;
+    }
+  }
+}
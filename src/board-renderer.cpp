@@ -0,0 +1,117 @@
+#include "../include/board-renderer.hpp"
+#include "../include/piece.hpp"
+
+namespace {
+  constexpr std::string_view kTopBorder{
+      "   -----------------------------------------------------------------\n"};
+  constexpr std::string_view kFileLabels{
+      "           A               B               C               D\n"};
+  // each square is 16 characters wide and 7 lines high; the board starts 3
+  // columns in (after the rank label) and 1 line down (after the border)
+  constexpr int kSquareWidth{16};
+  constexpr int kSquareHeight{7};
+  constexpr int kLeftMargin{3};
+  constexpr int kTopMargin{1};
+  // lines in a whole frame: the border, 4 rows of squares and the labels
+  constexpr int kFrameLines{kTopMargin + 4 * kSquareHeight + 1};
+  // a full frame plus its clear-screen prefix is about 2 KB; a diff frame of
+  // every square (cursor moves included) is larger still, so leave room
+  constexpr std::size_t kBufferSize{4096};
+}
+
+
+/* MEMBER FUNCTIONS */
+
+BoardRenderer::BoardRenderer(Mode mode) : mode_(mode) {
+  buffer_.reserve(kBufferSize);
+}
+
+// draws 'board' to 'out' with a single write, then flushes 'out'
+void BoardRenderer::render(const Chessboard& board, std::ostream& out) {
+  buffer_.clear();
+  if (mode_ == Mode::DIFF && drawn_) {
+    composeDiff(board);
+  } else {
+    if (mode_ == Mode::DIFF) {
+      // home the cursor and clear the screen, so the board sits at the top
+      buffer_ += "\x1b[H\x1b[2J";
+    }
+    composeFull(board);
+  }
+  previous_ = board.getPacked();
+  drawn_ = true;
+  out.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+  out.flush();
+}
+
+// forgets the previous frame, so the next DIFF frame is drawn in full
+void BoardRenderer::reset() {
+  drawn_ = false;
+}
+
+// returns the bytes written by the last render
+std::string_view BoardRenderer::getFrame() const {
+  return buffer_;
+}
+
+void BoardRenderer::composeFull(const Chessboard& board) {
+  buffer_ += kTopBorder;
+  for (int row = 0; row < 4; row++) {
+    for (int line = 0; line < kSquareHeight; line++) {
+      // the rank number goes on the third line of each row
+      if (line == 2) {
+        buffer_ += ' ';
+        buffer_ += static_cast<char>('4' - row);
+        buffer_ += ' ';
+      } else {
+        buffer_ += "   ";
+      }
+      for (int file = 0; file < 4; file++) {
+        appendImageLine(board, 4 * row + file, line);
+      }
+      buffer_ += line == kSquareHeight - 1 ? "-\n" : "|\n";
+    }
+  }
+  buffer_ += kFileLabels;
+}
+
+void BoardRenderer::composeDiff(const Chessboard& board) {
+  const std::uint64_t changed = board.getPacked() ^ previous_;
+  for (int index = 0; index < 16; index++) {
+    if (((changed >> (4 * index)) & 0xF) == 0) {
+      continue;
+    }
+    for (int line = 0; line < kSquareHeight; line++) {
+      appendCursor(kTopMargin + (index / 4) * kSquareHeight + line + 1,
+                   kLeftMargin + (index % 4) * kSquareWidth + 1);
+      appendImageLine(board, index, line);
+    }
+  }
+  appendCursor(kFrameLines + 1, 1);
+}
+
+// appends line 'line' (0-6) of the image of the piece on square 'index'
+void BoardRenderer::appendImageLine(const Chessboard& board, int index, int line) {
+  buffer_ += board[index].getImage()[line];
+}
+
+// appends the ANSI sequence moving the cursor to 'row', 'column' (1-based)
+void BoardRenderer::appendCursor(int row, int column) {
+  char digits[8];
+  buffer_ += "\x1b[";
+  int count{0};
+  for (int n = row; n > 0 || count == 0; n /= 10) {
+    digits[count++] = static_cast<char>('0' + n % 10);
+  }
+  while (count > 0) {
+    buffer_ += digits[--count];
+  }
+  buffer_ += ';';
+  for (int n = column; n > 0 || count == 0; n /= 10) {
+    digits[count++] = static_cast<char>('0' + n % 10);
+  }
+  while (count > 0) {
+    buffer_ += digits[--count];
+  }
+  buffer_ += 'H';
+}
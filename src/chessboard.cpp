@@ -1,475 +1,253 @@
 #include <iostream>
 
+#include "../include/attack-tables.hpp"
+#include "../include/board-renderer.hpp"
 #include "../include/chessboard.hpp"
 #include "../include/coord-conversions.hpp"
+#include "../include/level-pack.hpp"
 #include "../include/piece.hpp"
 #include "../include/piece-type-enum.hpp"
 
 
 /* MEMBER FUNCTIONS */
 
-// constructor for chessboard
-Chessboard::Chessboard(int level)
-    : board_(setUpBoard(level)) {}
+// constructor for the board of level 'level' of 'pack' (by default the
+// levels that ship with the game), straight from its packed record
+template <>
+BasicChessboard<4>::BasicChessboard(int level, const LevelPack& pack)
+    : squares_(0), hash_(0) {
+  const std::uint64_t* record =
+      level < 0 ? nullptr : pack.find(static_cast<std::uint32_t>(level));
+  if (record == nullptr) {
+    std::cout << "error: no level of that number found in the level pack.\n";
+    return;
+  }
+  squares_ = *record;
+  hash_ = hashOf(squares_);
+}
+
+// constructor for an arbitrary arrangement of pieces, given in left-to-right,
+// top-to-bottom order
+template <int N>
+BasicChessboard<N>::BasicChessboard(const std::array<PieceType::PieceType, N * N>& outline)
+    : squares_{} {
+  for (int i = 0; i < N * N; i++) {
+    wordOf(i) |= static_cast<std::uint64_t>(outline[i]) << shiftOf(i);
+  }
+  hash_ = hashOf(squares_);
+}
+
+// returns the board whose packed position (see getPacked) is 'packed'
+template <int N>
+BasicChessboard<N> BasicChessboard<N>::fromPacked(Packed packed) {
+  BasicChessboard board;
+  board.squares_ = packed;
+  board.hash_ = hashOf(packed);
+  return board;
+}
 
 // prints out the visual of what the board currently looks like
-void Chessboard::printBoard() {
-    std::cout << "   -----------------------------------------------------"
-              << "------------\n";
-    // prints out all rows of board
-    for (int i = 0; i <= 12; i += 4) {
-        // prints out one row of the board
-        for (int j = 0; j <= 6; j++) {
-            if (j == 2) {
-                std::cout << " " << 4 - (i / 4) << " ";
-            } else {
-                std::cout << "   ";
-            }
-            // prints out one line, one character high
-            for (int k = 0; k <= 3; k++) {
-                const std::array<std::string, 7>& image = board_[i+k].getImage();
-                std::cout << image[j];
-            }
-            if (j == 6) {
-                std::cout << "-\n";
-            } else {
-                std::cout << "|\n";
-            }
-        }
-    }
-    std::cout << "           A               B               C"
-              << "               D\n";
+// (composed into one buffer and written all at once by a BoardRenderer)
+template <>
+void BasicChessboard<4>::printBoard(std::ostream& out) const {
+  thread_local BoardRenderer renderer;
+  renderer.render(*this, out);
 }
 
-// returns vector of pieces representing the current board
-const std::array<Piece, 16>& Chessboard::getBoard() const {
-  return board_;
+// returns array of pieces representing the current board
+template <int N>
+std::array<Piece, N * N> BasicChessboard<N>::getBoard() const {
+  std::array<Piece, N * N> pieces{};
+  for (int i = 0; i < N * N; i++) {
+    pieces[i] = (*this)[i];
+  }
+  return pieces;
+}
+
+// returns a mask with bit i set if square i holds a piece of 'piece_type'
+template <int N>
+typename BasicChessboard<N>::Mask
+BasicChessboard<N>::getTypeMask(PieceType::PieceType piece_type) const {
+  // squares holding 'piece_type' become zero nibbles after the XOR; flipping
+  // the occupancy of what's left gives the squares that matched (the unused
+  // nibbles at the end of the last word match EMPTY, and are dropped)
+  Mask matches{0};
+  for (int word = 0; word < Traits::kWords; word++) {
+    const std::uint64_t diff = wordOf(16 * word) ^ (0x1111111111111111ULL * piece_type);
+    const std::uint64_t any_bit = diff | (diff >> 1) | (diff >> 2) | (diff >> 3);
+    matches |= static_cast<Mask>(
+        static_cast<Mask>(static_cast<std::uint16_t>(
+            ~gatherNibbles(any_bit & 0x1111111111111111ULL)))
+        << (16 * word));
+  }
+  return matches & Traits::kAllSquares;
 }
 
-// updates the board by replacing the Piece obj at 'new_pos' with the Piece obj
-// at 'old_pos';
-// also changes Piece obj at 'old_pos' to an empty Piece
-void Chessboard::updateBoard(const std::pair<int, int>& old_pos,
-                             const std::pair<int, int>& new_pos) {
-  // sets Piece obj at 'new_pos' equal to Piece obj at 'old_pos'
-  (*this)[new_pos] = (*this)[old_pos];
-  // resets the moved Piece obj's stored position value
-  (*this)[new_pos].setPosition(new_pos);
-  // sets Piece obj at 'old_pos' equal to an empty Piece obj
-  (*this)[old_pos] = Piece{PieceType::PieceType::EMPTY, old_pos};
+// returns the number of pieces left on the board
+template <int N>
+int BasicChessboard<N>::pieceCount() const {
+  return __builtin_popcountll(getOccupancy());
+}
+
+// updates the board by replacing the piece at 'new_pos' with the piece at
+// 'old_pos';
+// also empties the square at 'old_pos'
+template <int N>
+void BasicChessboard<N>::updateBoard(const std::pair<int, int>& old_pos,
+                                     const std::pair<int, int>& new_pos) {
+  STATS_ADD(Stats::UPDATE_BOARD_CALLS, 1);
+  makeMove(Coords::coordToIndex<N>(old_pos), Coords::coordToIndex<N>(new_pos));
 }
 
 // returns true if the spot on the board at the given coordinate coord has a
 // chess piece on it, false if spot is empty or not on board
-bool Chessboard::spotOccupied(const std::pair<int, int>& coord) const {
-  if (!Coords::coordExists(coord) ||
-      (*this)[coord].getPieceType() == PieceType::PieceType::EMPTY) {
+template <int N>
+bool BasicChessboard<N>::spotOccupied(const std::pair<int, int>& coord) const {
+  if (!Coords::coordExists<N>(coord)) {
     return false;
   }
-  return true;
+  return (getOccupancy() >> Coords::coordToIndex<N>(coord)) & 1;
 }
 
 // returns vector of int-int pairs representing the coordinates on the board to
 // which a piece at the given coordinate coord can move
 // the criteria for a piece to be able to move somewhere is if that where is an
 // existent coordinate on the board, and that coordinate is occupied
-std::vector<std::pair<int, int>> Chessboard::getMoves(const std::pair<int, int>& position) const {
+template <int N>
+std::vector<std::pair<int, int>>
+BasicChessboard<N>::getMoves(const std::pair<int, int>& position) const {
   // if 'position' doesn't exist on the board, print "error..." and return {-1,-1}
-  if (!Coords::coordExists(position)) {
+  if (!Coords::coordExists<N>(position)) {
     std::cout << "error: used non-existent coordinate to get moves.\n";
     return {{-1, -1}};
   }
 
-  const PieceType::PieceType piece_type = (*this)[position].getPieceType();
+  const int index = Coords::coordToIndex<N>(position);
+  const PieceType::PieceType piece_type = typeAt(index);
 
-  std::vector<std::pair<int, int>> moves{};
-
-  using namespace PieceType;
-
-  if (piece_type == EMPTY) {
+  if (piece_type == PieceType::EMPTY) {
     std::cout << "error: tried to get moves of empty piece.\n";
     return {{0, 0}};
-  } else if (piece_type == PAWN) {
-    // north
-    if (int y = position.first + 1; y <= 4) {
-      // northeast
-      if (int x = position.second + 1; x <= 4 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-      }
-      // northwest
-      if (int x = position.second - 1; x >= 1 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-      }
-    }
-  } else if (piece_type == ROOK) {
-
-    // north
-    for (int y = position.first + 1; y <= 4; y++) {
-      if (std::pair<int, int> curr_coord = {y, position.second}; spotOccupied(curr_coord)) {
-        moves.push_back({y, position.second});
-        break;
-      }
-    }
-    // east
-    for (int x = position.second + 1; x <= 4; x++) {
-      if (std::pair<int, int> curr_coord = {position.first, x}; spotOccupied(curr_coord)) {
-        moves.push_back(curr_coord);
-        break;
-      }
-    }
-    // south
-    for (int y = position.first - 1; y >= 1; y--) {
-      if (std::pair<int, int> curr_coord = {y, position.second}; spotOccupied(curr_coord)) {
-        moves.push_back(curr_coord);
-        break;
-      }
-    }
-    // west
-    for (int x = position.second - 1; x >= 1; x--) {
-      if (std::pair<int, int> curr_coord = {position.first, x}; spotOccupied(curr_coord)) {
-        moves.push_back(curr_coord);
-        break;
-      }
-    }
+  }
 
-  } else if (piece_type == KNIGHT) {
-
-    // north 2
-    if (int y = position.first + 2; y <= 4) {
-      // east 1
-      if (int x = position.second + 1; x <= 4 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-      }
-      // west 1
-      if (int x = position.second - 1; x >= 1 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-      }
-    } else if (int y = position.first - 2; y >= 1) {  // south 2
-      // east 1
-      if (int x = position.second; x <= 4 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-      }
-      // west 1
-      if (int x = position.second - 1; x >= 1 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-      }
-    }
-    //  east 2
-    if (int x = position.second + 2; x <= 4) {
-      // north 1
-      if (int y = position.first + 1; y <= 4 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-      }
-      // south 1
-      if (int y = position.first - 1; y >= 1 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-      }
-    } else if (int x = position.second - 2; x >= 1) {  // west 2
-      // north 1
-      if (int y = position.first + 1; y <= 4 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-      }
-      // south 1
-      if (int y = position.first - 1; y >= 1 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-      }
-    }
+  STATS_ADD(Stats::GET_MOVES_CALLS, 1);
+  STATS_ADD(Stats::movesOf(piece_type), __builtin_popcountll(getCaptures(index)));
+  std::vector<std::pair<int, int>> moves{};
+  // every set bit of the capture mask is one square the piece can attack
+  for (Mask captures = getCaptures(index); captures != 0; captures &= captures - 1) {
+    moves.push_back(Coords::indexToCoord<N>(lowestSquare(captures)));
+  }
+  return moves;
+}
 
-  } else if (piece_type == BISHOP) {
-
-    bool east_is_clear{true}, west_is_clear{true};
-
-    // north
-    for (int y = position.first + 1; y <= 4; y++) {
-      // northeast
-      if (int x = position.second + (y - position.first); east_is_clear && x <= 4 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-        east_is_clear = false;
-      }
-      // northwest
-      if (int x = position.second - (y - position.first); west_is_clear && x >= 1 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-        west_is_clear = false;
-      }
-    }
 
-    east_is_clear = west_is_clear = true;
-
-    // south
-    for (int y = position.first - 1; y >= 1; y--) {
-      // southeast
-      if (int x = position.second - (y - position.first); east_is_clear && x <= 4 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-        east_is_clear = false;
-      }
-      // southwest
-      if (int x = position.second + (y - position.first); west_is_clear && x >= 1 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-        west_is_clear = false;
-      }
-    }
+// appends the captures of the piece on square 'index' to 'moves'
+template <int N>
+void BasicChessboard<N>::getMoves(int index, MoveList& moves) const {
+  STATS_ADD(Stats::GET_MOVES_CALLS, 1);
+  STATS_ADD(Stats::movesOf(typeAt(index)), __builtin_popcountll(getCaptures(index)));
+  for (Mask captures = getCaptures(index); captures != 0;
+       captures &= captures - 1) {
+    moves.push(Move{static_cast<std::uint8_t>(index),
+                    static_cast<std::uint8_t>(lowestSquare(captures))});
+  }
+}
 
-  } else if (piece_type == QUEEN) {
-
-    bool north_is_clear{true}, east_is_clear{true}, west_is_clear{true};
-
-    // north
-    for (int y = position.first + 1; y <= 4; y++) {
-      if (north_is_clear && spotOccupied({y, position.second})) {
-        moves.push_back({y, position.second});
-        north_is_clear = false;
-      }
-
-      // northeast
-      if (int x = position.second + (y - position.first); east_is_clear && x <= 4 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-        east_is_clear = false;
-      }
-      // northwest
-      if (int x = position.second - (y - position.first); west_is_clear && x >= 1 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-        west_is_clear = false;
-      }
+// appends every capture of every piece on the board to 'moves'
+template <int N>
+void BasicChessboard<N>::getAllMoves(MoveList& moves) const {
+  STATS_ADD(Stats::GET_MOVES_CALLS, 1);
+  const Mask occ = getOccupancy();
+  for (Mask pieces = occ; pieces != 0; pieces &= pieces - 1) {
+    const int from = lowestSquare(pieces);
+    const Mask all_captures = Attacks::capturesOn<N>(typeAt(from), from, occ);
+    STATS_ADD(Stats::movesOf(typeAt(from)), __builtin_popcountll(all_captures));
+    for (Mask captures = all_captures; captures != 0; captures &= captures - 1) {
+      moves.push(Move{static_cast<std::uint8_t>(from),
+                      static_cast<std::uint8_t>(lowestSquare(captures))});
     }
+  }
+}
 
-    // east
-    for (int x = position.second + 1; x <= 4; x++) {
-      if (std::pair<int, int> curr_coord = {position.first, x}; spotOccupied(curr_coord)) {
-        moves.push_back(curr_coord);
-        break;
-      }
-    }
+// returns true if the piece at 'position' can capture anything, without
+// listing the captures
+template <int N>
+bool BasicChessboard<N>::hasMoves(const std::pair<int, int>& position) const {
+  return Coords::coordExists<N>(position) &&
+         getCaptures(Coords::coordToIndex<N>(position)) != 0;
+}
 
-    bool south_is_clear = east_is_clear = west_is_clear = true;
-
-    // south
-    for (int y = position.first - 1; y >= 1; y--) {
-      if (north_is_clear && spotOccupied({y, position.second})) {
-        moves.push_back({y, position.second});
-        south_is_clear = false;
-      }
-
-      // southeast
-      if (int x = position.second - (y - position.first); east_is_clear && x <= 4 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-        east_is_clear = false;
-      }
-      // southwest
-      if (int x = position.second + (y - position.first); west_is_clear && x >= 1 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-        west_is_clear = false;
-      }
-    }
+// returns the number of captures the piece at 'position' can make
+template <int N>
+int BasicChessboard<N>::moveCount(const std::pair<int, int>& position) const {
+  if (!Coords::coordExists<N>(position)) {
+    return 0;
+  }
+  return __builtin_popcountll(getCaptures(Coords::coordToIndex<N>(position)));
+}
 
-    // west
-    for (int x = position.second - 1; x >= 1; x--) {
-      if (std::pair<int, int> curr_coord = {position.first, x}; spotOccupied(curr_coord)) {
-        moves.push_back(curr_coord);
-        break;
-      }
-    }
 
-  } else {  // only remaining case is if piece_type == KING
-    // north
-    if (int y = position.first + 1; y <= 4) {
-      moves.push_back({y, position.second});
-      // northeast
-      if (int x = position.second + 1; x <= 4 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-      }
-      // northwest
-      if (int x = position.second - 1; x >= 1 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-      }
-    }
-    // east
-    if (int x = position.second + 1; x <= 4 && spotOccupied({position.first, x})) {
-      moves.push_back({position.first, x});
-    }
-    // west
-    if (int x = position.second - 1; x >= 1 && spotOccupied({position.first, x})) {
-      moves.push_back({position.first, x});
-    }
-    // south
-    if (int y = position.first - 1; y >= 1) {
-      if (std::pair<int, int> curr_coord{y, position.second}; spotOccupied(curr_coord)) {
-        moves.push_back(curr_coord);
-      }
-      // southeast
-      if (int x = position.second + 1; x <= 4 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-      }
-      // southwest
-      if (int x = position.second - 1; x >= 1 && spotOccupied({y, x})) {
-        moves.push_back({y, x});
-      }
-    }
+// plays the last move taken back again; returns false if there's none
+template <int N>
+bool BasicChessboard<N>::redo() {
+  if (!canRedo()) {
+    return false;
   }
+  const Record record = history_[history_size_];
+  const std::uint8_t redo_size = redo_size_;
+  makeMove(record & kSquareField, (record >> kSquareBits) & kSquareField);
+  redo_size_ = redo_size;
+  return true;
+}
 
-  return moves;
+// returns the last move played (only if canUndo())
+template <int N>
+Move BasicChessboard<N>::getLastMove() const {
+  const Record record = history_[history_size_ - 1];
+  return Move{static_cast<std::uint8_t>(record & kSquareField),
+              static_cast<std::uint8_t>((record >> kSquareBits) & kSquareField)};
 }
 
+// returns the Zobrist hash of the packed position 'packed'
+template <int N>
+std::uint64_t BasicChessboard<N>::hashOf(const Packed& packed) {
+  if constexpr (Traits::kWords == 1) {
+    return Zobrist::hashPacked(packed);
+  } else {
+    std::uint64_t hash{0};
+    for (int square = 0; square < N * N; square++) {
+      hash ^= Zobrist::kBoardKeys<N>[(packed[square >> 4] >> shiftOf(square)) & 0xF][square];
+    }
+    return hash;
+  }
+}
 
 
 /* OPERATOR OVERLOADS */
 
-Piece& Chessboard::operator[](int index) {
-  return board_[index];
-}
-const Piece& Chessboard::operator[](int index) const {
-  return board_[index];
+template <int N>
+Piece BasicChessboard<N>::operator[](int index) const {
+  return Piece{typeAt(index), Coords::indexToCoord<N>(index)};
 }
 
-Piece& Chessboard::operator[](const std::pair<int, int> &coord) {
-  // returns an index int within the range 0-15,
-  return operator[]( (-4) * ((coord.first) - 4) + ((coord.second) - 1) );
-}
-const Piece& Chessboard::operator[](const std::pair<int, int> &coord) const {
-  // returns an index int within the range 0-15,
-  return operator[]( (-4) * ((coord.first) - 4) + ((coord.second) - 1) );
+template <int N>
+Piece BasicChessboard<N>::operator[](const std::pair<int, int> &coord) const {
+  return operator[](Coords::coordToIndex<N>(coord));
 }
 
+// every board size, compiled once here
+template class BasicChessboard<4>;
+template class BasicChessboard<5>;
+template class BasicChessboard<6>;
+template class BasicChessboard<7>;
+template class BasicChessboard<8>;
+
 /* HELPER or NON-MEMBER FUNCTIONS */
 
 namespace {
 
-  // returns vector of Pieces based on return value of getLevelOutline(level)
-  std::array<Piece, 16> setUpBoard(int level) {
-    // creates a list of all the piece types in left-right, top-bottom order, and in
-    // the order they'll be in the beginning of the level number in the parameter
-    std::array<PieceType::PieceType, 16> piece_type_list(getLevelOutline(level));
-
-    // creates an array of Piece objects and fills it with the correct pieces at
-    // the correct places according to the piece_type_list array
-    std::array<Piece, 16> chess_board{};
-    for (int i = 0; i < 16; i ++) {
-      // creates a Piece with two parameters: piece type in the piece_type_list array at
-      // index "counter", and a std::pair<int, int> converted from an int index
-      Piece piece{piece_type_list.at(i), Coords::indexToCoord(i)};
-      // add Piece object that was just created to chess_board array
-      chess_board.at(i) = std::move(piece);
-    }
-
-    return chess_board;
-  }
-
-  // takes an int representing the level the user is on in Solitaire Chess
-  // returns array of ints representing the list of piece types in left-to-right,
-  // top-to-bottom order (like you'd read a book in English)
-  // 0 = empty, 1 = pawn, 2 = rook, 3 = knight, 4 = bishop, 5 = queen, 6 = king
-  std::array<PieceType::PieceType, 16> getLevelOutline(int level) {
-    using namespace PieceType;
-    if (level == 0) { return {EMPTY, EMPTY, ROOK, EMPTY,
-                              QUEEN, PAWN, EMPTY, EMPTY,
-                              KNIGHT, EMPTY, EMPTY, EMPTY,
-                              EMPTY, EMPTY, EMPTY, EMPTY}; // pg.9
-
-    } else if (level == 1) { return {EMPTY, EMPTY, EMPTY, EMPTY,
-                                     EMPTY, ROOK, EMPTY, KNIGHT,
-                                     BISHOP, KNIGHT, EMPTY, EMPTY,
-                                     EMPTY, EMPTY, EMPTY, EMPTY}; // pg.7
-
-    } else if (level == 2) { return {ROOK, EMPTY, QUEEN, EMPTY,
-                                    EMPTY, PAWN, EMPTY, EMPTY,
-                                    EMPTY, EMPTY, EMPTY, EMPTY,
-                                    KNIGHT, EMPTY, EMPTY, EMPTY}; // pg.11
-
-    } else if (level == 3) { return {EMPTY, KNIGHT, EMPTY, EMPTY,
-                                    EMPTY, QUEEN, EMPTY, ROOK,
-                                    PAWN, EMPTY, EMPTY, EMPTY,
-                                    EMPTY, EMPTY, EMPTY, EMPTY}; // pg.13
-
-    } else if (level == 4) { return {EMPTY, EMPTY, QUEEN, EMPTY,
-                                    EMPTY, EMPTY, ROOK, EMPTY,
-                                    KNIGHT, EMPTY, EMPTY, EMPTY,
-                                    EMPTY, PAWN, EMPTY, EMPTY}; // pg.16
-
-    } else if (level == 5) { return {EMPTY, EMPTY, PAWN, EMPTY,
-                                    KNIGHT, QUEEN, EMPTY, EMPTY,
-                                    EMPTY, BISHOP, EMPTY, EMPTY,
-                                    ROOK, EMPTY, EMPTY, EMPTY}; // pg.19
-
-    } else if (level == 6) { return {KING, EMPTY, ROOK, EMPTY,
-                                    EMPTY, EMPTY, BISHOP, EMPTY,
-                                    EMPTY, EMPTY, KNIGHT, EMPTY,
-                                    PAWN, EMPTY, EMPTY, EMPTY}; // pg.22
-
-    } else if (level == 7) { return {ROOK, EMPTY, EMPTY, EMPTY,
-                                    EMPTY, EMPTY, KING, PAWN,
-                                    KNIGHT, BISHOP, EMPTY, EMPTY,
-                                    EMPTY, EMPTY, EMPTY, EMPTY}; // pg.24
-
-    } else if (level == 8) { return {ROOK, EMPTY, EMPTY, EMPTY,
-                                    EMPTY, PAWN, KNIGHT, EMPTY,
-                                    EMPTY, EMPTY, EMPTY, EMPTY,
-                                    ROOK, EMPTY, KNIGHT, EMPTY}; // pg.25
-
-    } else if (level == 9) { return {ROOK, KNIGHT, EMPTY, EMPTY,
-                                    QUEEN, EMPTY, EMPTY, EMPTY,
-                                    EMPTY, BISHOP, EMPTY, EMPTY,
-                                    KNIGHT, EMPTY, PAWN, EMPTY}; // pg.33
-
-    } else if (level == 10) { return {EMPTY, ROOK, EMPTY, ROOK,
-                                      EMPTY, EMPTY, PAWN, EMPTY,
-                                      EMPTY, PAWN, EMPTY, EMPTY,
-                                      BISHOP, EMPTY, KNIGHT, EMPTY}; // pg.38
-
-    } else if (level == 11) { return {EMPTY, EMPTY, BISHOP, ROOK,
-                                      EMPTY, EMPTY, BISHOP, ROOK,
-                                      EMPTY, EMPTY, EMPTY, PAWN,
-                                      KNIGHT, EMPTY, EMPTY, EMPTY}; // pg.41
-
-    } else if (level == 12) { return {EMPTY, ROOK, EMPTY, KNIGHT,
-                                      KNIGHT, EMPTY, PAWN, EMPTY,
-                                      EMPTY, BISHOP, EMPTY, EMPTY,
-                                      EMPTY, EMPTY, PAWN, EMPTY}; // pg. 45
-
-    } else if (level == 13) { return {EMPTY, EMPTY, BISHOP, KNIGHT,
-                                      EMPTY, ROOK, BISHOP, PAWN,
-                                      KNIGHT, EMPTY, EMPTY, EMPTY,
-                                      EMPTY, PAWN, EMPTY, EMPTY}; // pg. 50
-
-    } else if (level == 14) { return {EMPTY, EMPTY, EMPTY, PAWN,
-                                      EMPTY, EMPTY, BISHOP, KNIGHT,
-                                      BISHOP, QUEEN, EMPTY, EMPTY,
-                                      EMPTY, KNIGHT, PAWN, EMPTY}; // pg. 54
-
-    } else if (level == 15) { return {ROOK, EMPTY, EMPTY, PAWN,
-                                      EMPTY, BISHOP, ROOK, EMPTY,
-                                      BISHOP, EMPTY, EMPTY, KNIGHT,
-                                      EMPTY, EMPTY, PAWN, EMPTY}; // pg. 59
-
-    } else if (level == 16) { return {EMPTY, EMPTY, ROOK, KNIGHT,
-                                      EMPTY, EMPTY, EMPTY, KNIGHT,
-                                      BISHOP, EMPTY, ROOK, EMPTY,
-                                      PAWN, EMPTY, EMPTY}; // pg. 62
-
-    } else if (level == 17) { return {PAWN, BISHOP, EMPTY, EMPTY,
-                                      KNIGHT, KNIGHT, EMPTY, EMPTY,
-                                      QUEEN, EMPTY, BISHOP, PAWN,
-                                      ROOK, EMPTY, EMPTY, EMPTY}; // pg. 66
-
-    } else if (level == 18) { return {EMPTY, EMPTY, KNIGHT, PAWN,
-                                      EMPTY, EMPTY, BISHOP, PAWN,
-                                      ROOK, ROOK, EMPTY, EMPTY,
-                                      BISHOP, KNIGHT, EMPTY, EMPTY}; // pg. 71
-
-    } else if (level == 19) { return {ROOK, ROOK, EMPTY, EMPTY,
-                                      KNIGHT, QUEEN, BISHOP, PAWN,
-                                      BISHOP, EMPTY, EMPTY, EMPTY,
-                                      EMPTY, EMPTY, PAWN, EMPTY}; // pg. 75
-
-    } else if (level == 20) { return {EMPTY, EMPTY, ROOK, PAWN,
-                                      EMPTY, ROOK, KNIGHT, EMPTY,
-                                      BISHOP, KNIGHT, EMPTY, EMPTY,
-                                      PAWN, BISHOP, EMPTY, EMPTY}; // pg. 79
-
-    } else {
-      std::cout << "error: no level of that number found; must be within range 0-20.\n";
-      return {EMPTY, EMPTY, EMPTY, EMPTY,
-              EMPTY, EMPTY, EMPTY, EMPTY,
-              EMPTY, EMPTY, EMPTY, EMPTY,
-              EMPTY, EMPTY, EMPTY, EMPTY};
-    }
+  // returns the index of the lowest set bit of a non-zero mask
+  int lowestSquare(std::uint64_t mask) {
+    return __builtin_ctzll(mask);
   }
 }
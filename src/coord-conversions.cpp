@@ -6,14 +6,8 @@
 
 namespace Coords {
   // returns true if coord param. exists in the grid of coordinates on the board
-  bool coordExists(std::pair<int, int> coord)
-  {
-    if ((coord.first > 4) || (coord.first < 1) || (coord.second > 4) ||
-        (coord.second < 1))
-    {
-      return false;
-    }
-    return true;
+  bool coordExists(std::pair<int, int> coord) {
+    return coordExists<4>(coord);
   }
 
   // converts 1A-format coordinate to two-digit coordinate
@@ -83,10 +77,14 @@ namespace Coords {
     if (index < 0 || index > 15) {
       std::cout << "error: no index of that value on board.\n";
     }
-    // converts 0-3 to 4 ; 4-7 to 3 ; 8-11 to 2 ; and 12-15 to 1
-    int y_pos{4 - (index / 4)};
-    // converts 0,4,8,12 to 1 ; 1,5,9,13 to 2 ; 2,6,10,14 to 3 ; 3,7,11,15 to 4
-    int x_pos{1 + (index % 4)};
-    return std::pair<int, int> {y_pos, x_pos};
+    // converts 0-3 to 4 ; 4-7 to 3 ; 8-11 to 2 ; and 12-15 to 1 (rows), and
+    // 0,4,8,12 to 1 ; 1,5,9,13 to 2 ; 2,6,10,14 to 3 ; 3,7,11,15 to 4 (columns)
+    return indexToCoord<4>(index);
+  }
+
+  // converts two-digit coordinate to index (0-15, left-to-right, top-to-bottom)
+  int coordToIndex(const std::pair<int, int>& coord) {
+    // converts y_pos 4 to 0-3 ; 3 to 4-7 ; 2 to 8-11 ; and 1 to 12-15
+    return coordToIndex<4>(coord);
   }
 }
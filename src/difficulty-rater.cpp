@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "../include/attack-tables.hpp"
+#include "../include/chessboard.hpp"
+#include "../include/difficulty-rater.hpp"
+#include "../include/stats.hpp"
+#include "../include/symmetry.hpp"
+#include "../include/zobrist.hpp"
+
+namespace {
+  // lowest score of each grade above EASY, in Grade order; roughly the
+  // quartiles of the built-in levels' scores (which run from 0.8 to 12)
+  constexpr double kGradeScores[3]{3.5, 5.0, 8.0};
+}
+
+
+/* MEMBER FUNCTIONS */
+
+// constructor for the difficulty rater
+DifficultyRater::DifficultyRater(std::size_t kilobytes) {
+  // largest power of two number of slots within the budget (at least one)
+  std::size_t count{1};
+  while (count * 2 * sizeof(Slot) <= kilobytes * 1024) {
+    count *= 2;
+  }
+  slots_.resize(count, Slot{0, {}});
+  mask_ = count - 1;
+}
+
+// returns the rating of 'board'
+DifficultyRater::Rating DifficultyRater::rate(const Chessboard& board) {
+  const Subtree tree = walk(board);
+  Rating rating{};
+  rating.tree_size = tree.size;
+  rating.solutions = tree.solutions;
+  rating.dead_ends = tree.dead_ends;
+  rating.branching = tree.inner != 0 ? static_cast<double>(tree.captures) / tree.inner : 0;
+  rating.dead_end_ratio = tree.solutions != 0
+                              ? static_cast<double>(tree.dead_ends) / tree.solutions
+                              : std::numeric_limits<double>::infinity();
+  rating.first_mistake = tree.first_mistake;
+  rating.random_win_chance = tree.win_chance;
+  if (tree.solutions == 0) {
+    rating.score = std::numeric_limits<double>::infinity();
+    rating.grade = Grade::UNSOLVABLE;
+    return rating;
+  }
+  rating.score = std::log2(1 / tree.win_chance);
+  rating.grade = static_cast<Grade>(
+      std::upper_bound(std::begin(kGradeScores), std::end(kGradeScores), rating.score) -
+      std::begin(kGradeScores));
+  return rating;
+}
+
+// returns the name of 'grade' ("easy", "intermediate", ...)
+const char* DifficultyRater::gradeName(Grade grade) {
+  switch (grade) {
+    case Grade::EASY: return "easy";
+    case Grade::INTERMEDIATE: return "intermediate";
+    case Grade::ADVANCED: return "advanced";
+    case Grade::EXPERT: return "expert";
+    default: return "unsolvable";
+  }
+}
+
+std::uint64_t DifficultyRater::getNodes() const {
+  return nodes_;
+}
+
+// returns the figures for the tree below 'board', from the table if they're
+// there
+DifficultyRater::Subtree DifficultyRater::walk(const Chessboard& board) {
+  const std::uint16_t occ = board.getOccupancy();
+  // one piece left (or none, which isn't a position play can reach)
+  if ((occ & (occ - 1)) == 0) {
+    return {1, 0, 0, occ != 0 ? 1u : 0u, 0, occ != 0 ? 1.0 : 0.0, 0};
+  }
+
+  // a board and its symmetric images have the same tree, captures mapped
+  const std::uint64_t key = Symmetry::canonical(board.getPacked());
+  Slot& slot = slots_[Zobrist::hashPacked(key) & mask_];
+  if (slot.key == key) {
+    return slot.subtree;
+  }
+
+  nodes_++;
+  STATS_ADD(Stats::SOLVER_NODES, 1);
+  Subtree tree{1, 0, 0, 0, 0, 0.0, 0};
+  // captures from this position
+  int branches{0};
+  // the fewest captures, along winning ones, until a losing one is possible
+  int first_mistake{UINT8_MAX};
+  bool can_lose{false};
+  for (std::uint16_t pieces = occ; pieces != 0; pieces &= pieces - 1) {
+    const int from = __builtin_ctz(pieces);
+    const std::uint16_t all_captures = Attacks::captures(board.typeAt(from), from, occ);
+    STATS_ADD(Stats::movesOf(board.typeAt(from)), __builtin_popcount(all_captures));
+    for (std::uint16_t captures = all_captures; captures != 0; captures &= captures - 1) {
+      Chessboard next = board;
+      next.makeMove(from, __builtin_ctz(captures));
+      const Subtree child = walk(next);
+      tree.size = addCapped(tree.size, child.size);
+      tree.inner = addCapped(tree.inner, child.inner);
+      tree.captures = addCapped(tree.captures, child.captures);
+      tree.solutions = addCapped(tree.solutions, child.solutions);
+      tree.dead_ends = addCapped(tree.dead_ends, child.dead_ends);
+      tree.win_chance += child.win_chance;
+      if (child.solutions == 0) {
+        can_lose = true;
+      } else {
+        first_mistake = std::min(first_mistake, child.first_mistake + 1);
+      }
+      branches++;
+    }
+  }
+
+  if (branches == 0) {
+    tree.dead_ends = 1;
+  } else {
+    tree.inner = addCapped(tree.inner, 1);
+    tree.captures = addCapped(tree.captures, branches);
+    tree.win_chance /= branches;
+  }
+  tree.first_mistake = static_cast<std::uint8_t>(
+      tree.solutions == 0 || can_lose ? 0 : first_mistake);
+
+  slot = {key, tree};
+  return tree;
+}
+
+
+
+/* HELPER or NON-MEMBER FUNCTIONS */
+
+namespace {
+
+  // returns a + b, or UINT64_MAX if that doesn't fit
+  std::uint64_t addCapped(std::uint64_t a, std::uint64_t b) {
+    std::uint64_t sum;
+    return __builtin_add_overflow(a, b, &sum) ? UINT64_MAX : sum;
+  }
+}
@@ -0,0 +1,285 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <unordered_set>
+
+#include "../include/attack-tables.hpp"
+#include "../include/chessboard.hpp"
+#include "../include/generator.hpp"
+#include "../include/notation.hpp"
+#include "../include/piece-type-enum.hpp"
+#include "../include/solution-counter.hpp"
+#include "../include/solver.hpp"
+#include "../include/stats.hpp"
+#include "../include/symmetry.hpp"
+#include "../include/tablebase.hpp"
+
+
+/* MEMBER FUNCTIONS */
+
+// constructor for the generator
+Generator::Generator(const Options& options)
+    : options_(options),
+      // only one of the solver and the counter is used, so only its table
+      // gets the memory budget
+      table_(options.unique ? 1 : options.table_megabytes * 1024),
+      solver_(&table_),
+      counter_(options.unique ? options.table_megabytes * 1024 : 1) {
+  // converts the piece letters to piece types
+  for (char letter : options_.mix) {
+    const int piece_type = Notation::letterToType(letter);
+    if (piece_type < 0) {
+      std::cerr << "error: '" << letter << "' is not a piece letter.\n";
+      continue;
+    }
+    types_.push_back(static_cast<PieceType::PieceType>(piece_type));
+  }
+  if (options_.exact_mix) {
+    options_.pieces = static_cast<int>(types_.size());
+  }
+  // next_permutation walks through the exact mix starting from sorted order;
+  // otherwise each type only needs to appear once
+  std::sort(types_.begin(), types_.end());
+  if (!options_.exact_mix) {
+    types_.erase(std::unique(types_.begin(), types_.end()), types_.end());
+  }
+}
+
+// lets the solver answer boards small enough for 'tablebase' from it
+void Generator::setTablebase(const Tablebase* tablebase) {
+  solver_.setTablebase(tablebase);
+  counter_.setTablebase(tablebase);
+}
+
+// writes every solvable (or, with 'unique', uniquely solvable) board found to
+// 'out'
+// returns the number of boards written
+std::uint64_t Generator::run(std::ostream& out) {
+  STATS_PHASE(Stats::GENERATE);
+  out_ = &out;
+  buffer_.reserve(1 << 16);
+  if (!types_.empty() && options_.pieces > 0 && options_.pieces <= 16) {
+    if (options_.retrograde) {
+      retrograde();
+    } else if (options_.samples == 0) {
+      enumerate();
+    } else {
+      sample();
+    }
+  }
+  flush(true);
+  return found_;
+}
+
+std::uint64_t Generator::getCandidates() const {
+  return candidates_;
+}
+
+std::uint64_t Generator::getDuplicates() const {
+  return duplicates_;
+}
+
+// checks one placement; 'squares' holds one bit per piece and 'types' the
+// piece types to put on them, in square order
+// returns false once the limit has been reached
+bool Generator::consider(std::uint16_t squares, const PieceType::PieceType* types) {
+  std::uint64_t packed{0};
+  for (int i = 0; squares != 0; squares &= squares - 1, i++) {
+    packed |= static_cast<std::uint64_t>(types[i]) << (4 * __builtin_ctz(squares));
+  }
+  // of a board and its symmetric images, only the canonical form is kept
+  if (Symmetry::canonical(packed) != packed) {
+    duplicates_++;
+    return true;
+  }
+
+  candidates_++;
+  if (keep(packed)) {
+    Notation::append(packed, buffer_);
+    buffer_ += '\n';
+    flush(false);
+    found_++;
+  }
+  return options_.limit == 0 || found_ < options_.limit;
+}
+
+// returns true if 'packed' is a board to keep: solvable, and with 'unique',
+// solvable only one way
+bool Generator::keep(std::uint64_t packed) {
+  // the counter stops at a second solution, and remembers dead ends just as
+  // the solver does, so it turns down unsolvable boards about as fast
+  const Chessboard board = Chessboard::fromPacked(packed);
+  return options_.unique ? counter_.isUnique(board) : solver_.isSolvable(board);
+}
+
+// walks through every placement of the pieces, square set by square set
+void Generator::enumerate() {
+  const int pieces = options_.pieces;
+  std::vector<PieceType::PieceType> types(pieces);
+  // indices into 'types_' for every piece when the mix isn't exact
+  std::vector<std::size_t> digits(pieces);
+
+  // every 16-bit mask with 'pieces' bits set, in increasing order
+  for (std::uint32_t squares = (1u << pieces) - 1; squares < (1u << 16);) {
+    if (options_.exact_mix) {
+      std::copy(types_.begin(), types_.end(), types.begin());
+      do {
+        if (!consider(static_cast<std::uint16_t>(squares), types.data())) {
+          return;
+        }
+      } while (std::next_permutation(types.begin(), types.end()));
+    } else {
+      std::fill(digits.begin(), digits.end(), 0);
+      while (true) {
+        for (int i = 0; i < pieces; i++) {
+          types[i] = types_[digits[i]];
+        }
+        if (!consider(static_cast<std::uint16_t>(squares), types.data())) {
+          return;
+        }
+        // counts up in base 'types_.size()'
+        int i{0};
+        while (i < pieces && ++digits[i] == types_.size()) {
+          digits[i++] = 0;
+        }
+        if (i == pieces) {
+          break;
+        }
+      }
+    }
+
+    // next mask with the same number of bits set (Gosper's hack)
+    const std::uint32_t lowest = squares & -squares;
+    const std::uint32_t ripple = squares + lowest;
+    squares = (((ripple ^ squares) >> 2) / lowest) | ripple;
+  }
+}
+
+// tries 'samples' random placements; boards already written are remembered so
+// none is written twice
+void Generator::sample() {
+  std::mt19937_64 rng{options_.seed};
+  std::vector<PieceType::PieceType> types(options_.pieces);
+  std::unordered_set<std::uint64_t> seen;
+
+  for (std::uint64_t i = 0; i < options_.samples; i++) {
+    std::uint16_t squares{0};
+    while (__builtin_popcount(squares) < options_.pieces) {
+      squares |= 1 << (rng() % 16);
+    }
+    if (options_.exact_mix) {
+      std::copy(types_.begin(), types_.end(), types.begin());
+      std::shuffle(types.begin(), types.end(), rng);
+    } else {
+      for (PieceType::PieceType& piece_type : types) {
+        piece_type = types_[rng() % types_.size()];
+      }
+    }
+
+    // samples are canonicalized up front so repeats can be spotted
+    std::uint64_t packed{0};
+    int j{0};
+    for (std::uint16_t rest = squares; rest != 0; rest &= rest - 1, j++) {
+      packed |= static_cast<std::uint64_t>(types[j]) << (4 * __builtin_ctz(rest));
+    }
+    packed = Symmetry::canonical(packed);
+    if (seen.count(packed) != 0) {
+      duplicates_++;
+      continue;
+    }
+
+    candidates_++;
+    if (keep(packed)) {
+      emit(packed, seen);
+      if (options_.limit != 0 && found_ >= options_.limit) {
+        return;
+      }
+    }
+  }
+}
+
+// builds boards backwards: starting from one piece, repeatedly picks a piece
+// on the board, moves it back to a square it could have captured from, and
+// puts a new piece where it landed, until the board has enough pieces
+// playing those captures forwards again always solves the board
+void Generator::retrograde() {
+  std::mt19937_64 rng{options_.seed};
+  const std::uint64_t boards = options_.samples != 0 ? options_.samples : 1000;
+  std::unordered_set<std::uint64_t> seen;
+  // (origin, destination) of every possible un-capture
+  std::vector<std::pair<int, int>> uncaptures;
+  uncaptures.reserve(16 * 15);
+
+  for (std::uint64_t i = 0; i < boards; i++) {
+    // pieces still to be placed; with an exact mix they're used up one each
+    std::vector<PieceType::PieceType> supply{types_};
+    auto draw = [&]() {
+      const std::size_t pick = rng() % supply.size();
+      const PieceType::PieceType piece_type = supply[pick];
+      if (options_.exact_mix) {
+        supply.erase(supply.begin() + pick);
+      }
+      return piece_type;
+    };
+
+    std::uint64_t packed = static_cast<std::uint64_t>(draw()) << (4 * (rng() % 16));
+    std::uint16_t occ = Chessboard::fromPacked(packed).getOccupancy();
+    for (int pieces = 1; pieces < options_.pieces; pieces++) {
+      uncaptures.clear();
+      for (std::uint16_t rest = occ; rest != 0; rest &= rest - 1) {
+        const int to = __builtin_ctz(rest);
+        const auto mover = static_cast<PieceType::PieceType>((packed >> (4 * to)) & 0xF);
+        for (std::uint16_t from = Attacks::origins(mover, to, occ); from != 0;
+             from &= from - 1) {
+          uncaptures.push_back({__builtin_ctz(from), to});
+        }
+      }
+      // every piece is stuck (e.g. a lone pawn on the bottom row)
+      if (uncaptures.empty()) {
+        break;
+      }
+
+      const auto [from, to] = uncaptures[rng() % uncaptures.size()];
+      const std::uint64_t mover = (packed >> (4 * to)) & 0xF;
+      packed &= ~(0xFULL << (4 * to));
+      packed |= (mover << (4 * from)) | (static_cast<std::uint64_t>(draw()) << (4 * to));
+      occ |= 1 << from;
+    }
+
+    candidates_++;
+    // built boards are solvable, but may well be solvable more than one way
+    if (__builtin_popcount(occ) == options_.pieces &&
+        (!options_.unique || counter_.isUnique(Chessboard::fromPacked(packed)))) {
+      emit(packed, seen);
+      if (options_.limit != 0 && found_ >= options_.limit) {
+        return;
+      }
+    }
+  }
+}
+
+// writes one board out, unless it (or one of its symmetric images) has been
+// seen
+void Generator::emit(std::uint64_t packed, std::unordered_set<std::uint64_t>& seen) {
+  if (!seen.insert(Symmetry::canonical(packed)).second) {
+    duplicates_++;
+    return;
+  }
+  Notation::append(packed, buffer_);
+  buffer_ += '\n';
+  flush(false);
+  found_++;
+}
+
+// writes the buffered boards out once there are enough of them (or always,
+// if 'force')
+void Generator::flush(bool force) {
+  if (force || buffer_.size() >= (1 << 16) - 32) {
+    out_->write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+    if (force) {
+      out_->flush();
+    }
+  }
+}
+
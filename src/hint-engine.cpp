@@ -0,0 +1,49 @@
+#include "../include/hint-engine.hpp"
+#include "../include/stats.hpp"
+
+
+/* MEMBER FUNCTIONS */
+
+// constructor for the hint engine; every hint that needs a search gets at
+// most 'budget' of it
+// the table only has to hold the positions of one level, so it's kept small
+HintEngine::HintEngine(std::chrono::microseconds budget)
+    : budget_(budget), table_(1024), solver_(&table_) {}
+
+// answers positions small enough for 'tablebase' straight from it
+void HintEngine::setTablebase(const Tablebase* tablebase) {
+  solver_.setTablebase(tablebase);
+}
+
+// returns a winning capture for 'board', or why there is none
+HintEngine::Hint HintEngine::hint(const Chessboard& board) {
+  STATS_PHASE(Stats::HINT);
+  if (board.pieceCount() <= 1) {
+    return {board.pieceCount() == 1 ? Status::SOLVED : Status::UNSOLVABLE, Move{}};
+  }
+
+  // still on the cached line
+  const std::uint64_t packed = board.getPacked();
+  for (int i = 0; i < line_size_; i++) {
+    if (positions_[i] == packed) {
+      return {Status::WINNING, line_[i]};
+    }
+  }
+
+  solver_.setDeadline(std::chrono::steady_clock::now() + budget_);
+  const std::optional<std::vector<Move>> solution = solver_.solve(board);
+  solver_.clearDeadline();
+  if (!solution) {
+    return {solver_.wasAborted() ? Status::TIMEOUT : Status::UNSOLVABLE, Move{}};
+  }
+
+  // remembers the line, with the position each move is played from
+  Chessboard next = board;
+  line_size_ = 0;
+  for (const Move& move : *solution) {
+    line_[line_size_] = move;
+    positions_[line_size_++] = next.getPacked();
+    next.makeMove(move.from, move.to);
+  }
+  return {Status::WINNING, line_[0]};
+}
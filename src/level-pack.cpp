@@ -0,0 +1,334 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../include/constexpr-solver.hpp"
+#include "../include/level-pack.hpp"
+#include "../include/piece-type-enum.hpp"
+
+namespace {
+  // the arrangement of every built-in level, in left-to-right, top-to-bottom
+  // order (like you'd read a book in English), with the page of the puzzle
+  // book it comes from
+  using Outline = std::array<PieceType::PieceType, 16>;
+  using namespace PieceType;
+
+  // returns the outline listing 'squares'; an Outline on its own would pad a
+  // short list with EMPTY, so each level goes through here to have its
+  // squares counted
+  template <std::size_t Count>
+  constexpr Outline outline(const PieceType::PieceType (&squares)[Count]) {
+    static_assert(Count == 16, "a level lists all 16 squares of the board");
+    Outline result{};
+    for (std::size_t i = 0; i < Count; i++) {
+      result[i] = squares[i];
+    }
+    return result;
+  }
+
+  constexpr std::array<Outline, 21> kOutlines{{
+      outline({EMPTY, EMPTY, ROOK, EMPTY,
+               QUEEN, PAWN, EMPTY, EMPTY,
+               KNIGHT, EMPTY, EMPTY, EMPTY,
+               EMPTY, EMPTY, EMPTY, EMPTY}), // level 0, pg. 9
+      outline({EMPTY, EMPTY, EMPTY, EMPTY,
+               EMPTY, ROOK, EMPTY, KNIGHT,
+               BISHOP, KNIGHT, EMPTY, EMPTY,
+               EMPTY, EMPTY, EMPTY, EMPTY}), // level 1, pg. 7
+      outline({ROOK, EMPTY, QUEEN, EMPTY,
+               EMPTY, PAWN, EMPTY, EMPTY,
+               EMPTY, EMPTY, EMPTY, EMPTY,
+               KNIGHT, EMPTY, EMPTY, EMPTY}), // level 2, pg. 11
+      outline({EMPTY, KNIGHT, EMPTY, EMPTY,
+               EMPTY, QUEEN, EMPTY, ROOK,
+               PAWN, EMPTY, EMPTY, EMPTY,
+               EMPTY, EMPTY, EMPTY, EMPTY}), // level 3, pg. 13
+      outline({EMPTY, EMPTY, QUEEN, EMPTY,
+               EMPTY, EMPTY, ROOK, EMPTY,
+               KNIGHT, EMPTY, EMPTY, EMPTY,
+               EMPTY, PAWN, EMPTY, EMPTY}), // level 4, pg. 16
+      outline({EMPTY, EMPTY, PAWN, EMPTY,
+               KNIGHT, QUEEN, EMPTY, EMPTY,
+               EMPTY, BISHOP, EMPTY, EMPTY,
+               ROOK, EMPTY, EMPTY, EMPTY}), // level 5, pg. 19
+      outline({KING, EMPTY, ROOK, EMPTY,
+               EMPTY, EMPTY, BISHOP, EMPTY,
+               EMPTY, EMPTY, KNIGHT, EMPTY,
+               PAWN, EMPTY, EMPTY, EMPTY}), // level 6, pg. 22
+      outline({ROOK, EMPTY, EMPTY, EMPTY,
+               EMPTY, EMPTY, KING, PAWN,
+               KNIGHT, BISHOP, EMPTY, EMPTY,
+               EMPTY, EMPTY, EMPTY, EMPTY}), // level 7, pg. 24
+      outline({ROOK, EMPTY, EMPTY, EMPTY,
+               EMPTY, PAWN, KNIGHT, EMPTY,
+               EMPTY, EMPTY, EMPTY, EMPTY,
+               ROOK, EMPTY, KNIGHT, EMPTY}), // level 8, pg. 25
+      outline({ROOK, KNIGHT, EMPTY, EMPTY,
+               QUEEN, EMPTY, EMPTY, EMPTY,
+               EMPTY, BISHOP, EMPTY, EMPTY,
+               KNIGHT, EMPTY, PAWN, EMPTY}), // level 9, pg. 33
+      outline({EMPTY, ROOK, EMPTY, ROOK,
+               EMPTY, EMPTY, PAWN, EMPTY,
+               EMPTY, PAWN, EMPTY, EMPTY,
+               BISHOP, EMPTY, KNIGHT, EMPTY}), // level 10, pg. 38
+      outline({EMPTY, EMPTY, BISHOP, ROOK,
+               EMPTY, EMPTY, BISHOP, ROOK,
+               EMPTY, EMPTY, EMPTY, PAWN,
+               KNIGHT, EMPTY, EMPTY, EMPTY}), // level 11, pg. 41
+      outline({EMPTY, ROOK, EMPTY, KNIGHT,
+               KNIGHT, EMPTY, PAWN, EMPTY,
+               EMPTY, BISHOP, EMPTY, EMPTY,
+               EMPTY, EMPTY, PAWN, EMPTY}), // level 12, pg. 45
+      outline({EMPTY, EMPTY, BISHOP, KNIGHT,
+               EMPTY, ROOK, BISHOP, PAWN,
+               KNIGHT, EMPTY, EMPTY, EMPTY,
+               EMPTY, PAWN, EMPTY, EMPTY}), // level 13, pg. 50
+      outline({EMPTY, EMPTY, EMPTY, PAWN,
+               EMPTY, EMPTY, BISHOP, KNIGHT,
+               BISHOP, QUEEN, EMPTY, EMPTY,
+               EMPTY, KNIGHT, PAWN, EMPTY}), // level 14, pg. 54
+      outline({ROOK, EMPTY, EMPTY, PAWN,
+               EMPTY, BISHOP, ROOK, EMPTY,
+               BISHOP, EMPTY, EMPTY, KNIGHT,
+               EMPTY, EMPTY, PAWN, EMPTY}), // level 15, pg. 59
+      outline({EMPTY, EMPTY, ROOK, KNIGHT,
+               EMPTY, EMPTY, EMPTY, KNIGHT,
+               BISHOP, EMPTY, ROOK, EMPTY,
+               PAWN, EMPTY, EMPTY, EMPTY}), // level 16, pg. 62
+      outline({PAWN, BISHOP, EMPTY, EMPTY,
+               KNIGHT, KNIGHT, EMPTY, EMPTY,
+               QUEEN, EMPTY, BISHOP, PAWN,
+               ROOK, EMPTY, EMPTY, EMPTY}), // level 17, pg. 66
+      outline({EMPTY, EMPTY, KNIGHT, PAWN,
+               EMPTY, EMPTY, BISHOP, PAWN,
+               ROOK, ROOK, EMPTY, EMPTY,
+               BISHOP, KNIGHT, EMPTY, EMPTY}), // level 18, pg. 71
+      outline({ROOK, ROOK, EMPTY, EMPTY,
+               KNIGHT, QUEEN, BISHOP, PAWN,
+               BISHOP, EMPTY, EMPTY, EMPTY,
+               EMPTY, EMPTY, PAWN, EMPTY}), // level 19, pg. 75
+      outline({EMPTY, EMPTY, ROOK, PAWN,
+               EMPTY, ROOK, KNIGHT, EMPTY,
+               BISHOP, KNIGHT, EMPTY, EMPTY,
+               PAWN, BISHOP, EMPTY, EMPTY}), // level 20, pg. 79
+  }};
+
+  // packs an outline into a record (four bits per square, square 0 lowest)
+  constexpr std::array<std::uint64_t, 21> makeRecords() {
+    std::array<std::uint64_t, 21> records{};
+    for (std::size_t level = 0; level < kOutlines.size(); level++) {
+      for (int i = 0; i < 16; i++) {
+        records[level] |= static_cast<std::uint64_t>(kOutlines[level][i]) << (4 * i);
+      }
+    }
+    return records;
+  }
+  constexpr std::array<std::uint64_t, 21> kRecords{makeRecords()};
+
+  // fails the build (naming the level in the instantiation) if built-in
+  // level 'Level' can't be solved
+  template <std::size_t Level>
+  constexpr bool checkSolvable() {
+    static_assert(ConstexprSolver::isSolvable(kRecords[Level]),
+                  "every built-in level must be solvable");
+    return true;
+  }
+  template <std::size_t... Levels>
+  constexpr bool checkAllSolvable(std::index_sequence<Levels...>) {
+    return (checkSolvable<Levels>() && ...);
+  }
+  static_assert(checkAllSolvable(std::make_index_sequence<kRecords.size()>{}));
+
+  constexpr std::array<std::uint32_t, 21> makeLevelNumbers() {
+    std::array<std::uint32_t, 21> levels{};
+    for (std::uint32_t level = 0; level < levels.size(); level++) {
+      levels[level] = level;
+    }
+    return levels;
+  }
+  constexpr std::array<std::uint32_t, 21> kLevelNumbers{makeLevelNumbers()};
+}
+
+
+/* MEMBER FUNCTIONS */
+
+LevelPack::LevelPack(const std::uint32_t* levels, const std::uint64_t* records,
+                     std::uint32_t count)
+    : levels_(levels), records_(records), count_(count) {}
+
+LevelPack::~LevelPack() {
+  close();
+}
+
+// returns the pack of the levels that ship with the game
+const LevelPack& LevelPack::builtin() {
+  static const LevelPack pack{kLevelNumbers.data(), kRecords.data(),
+                              static_cast<std::uint32_t>(kRecords.size())};
+  return pack;
+}
+
+// writes 'levels' (level number, packed board) as a pack file at 'path';
+// returns false if the file couldn't be written
+bool LevelPack::write(std::vector<std::pair<std::uint32_t, std::uint64_t>> levels,
+                      const std::string& path) {
+  std::sort(levels.begin(), levels.end());
+  levels.erase(std::unique(levels.begin(), levels.end(),
+                           [](const auto& a, const auto& b) { return a.first == b.first; }),
+               levels.end());
+
+  std::ofstream file{path, std::ios::binary};
+  if (!file) {
+    std::cerr << "error: couldn't write level pack to " << path << ".\n";
+    return false;
+  }
+  const auto count = static_cast<std::uint32_t>(levels.size());
+  const Header header{{'S', 'C', 'L', 'P'}, 1, count, 0};
+  file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+  std::vector<char> section(recordsOffset(count) - sizeof(Header), 0);
+  for (std::uint32_t i = 0; i < count; i++) {
+    std::memcpy(section.data() + 4 * i, &levels[i].first, 4);
+  }
+  file.write(section.data(), static_cast<std::streamsize>(section.size()));
+
+  section.assign(8 * static_cast<std::size_t>(count), 0);
+  for (std::uint32_t i = 0; i < count; i++) {
+    std::memcpy(section.data() + 8 * i, &levels[i].second, 8);
+  }
+  file.write(section.data(), static_cast<std::streamsize>(section.size()));
+  return static_cast<bool>(file);
+}
+
+// memory-maps the pack file at 'path'; returns false (leaving the pack empty)
+// if it's missing or malformed
+bool LevelPack::open(const std::string& path) {
+  close();
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat info{};
+  if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(Header)) {
+    ::close(fd);
+    return false;
+  }
+  void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+
+  Header header;
+  std::memcpy(&header, mapping, sizeof(Header));
+  const bool valid = std::memcmp(header.magic, "SCLP", 4) == 0 && header.version == 1 &&
+                     recordsOffset(header.count) + 8 * static_cast<std::size_t>(header.count) <=
+                         static_cast<std::size_t>(info.st_size);
+  if (!valid) {
+    std::cerr << "error: " << path << " is not a valid level pack.\n";
+    munmap(mapping, info.st_size);
+    return false;
+  }
+
+  // every record gets used as a board and every lookup searches the level
+  // numbers, so both are checked once here rather than on every use
+  const auto* bytes = static_cast<const std::uint8_t*>(mapping);
+  const auto* levels = reinterpret_cast<const std::uint32_t*>(bytes + sizeof(Header));
+  const auto* records =
+      reinterpret_cast<const std::uint64_t*>(bytes + recordsOffset(header.count));
+  if (!validContents(levels, records, header.count)) {
+    std::cerr << "error: " << path << " is not a valid level pack (its levels must be in "
+              << "ascending order and hold only pieces).\n";
+    munmap(mapping, info.st_size);
+    return false;
+  }
+  levels_ = levels;
+  records_ = records;
+  count_ = header.count;
+  mapping_ = mapping;
+  size_ = info.st_size;
+  return true;
+}
+
+void LevelPack::close() {
+  if (mapping_ != nullptr) {
+    munmap(mapping_, size_);
+    levels_ = nullptr;
+    records_ = nullptr;
+    count_ = 0;
+  }
+  mapping_ = nullptr;
+  size_ = 0;
+}
+
+// returns the number of levels in the pack
+std::uint32_t LevelPack::size() const {
+  return count_;
+}
+
+std::uint32_t LevelPack::levelAt(std::uint32_t i) const {
+  return levels_[i];
+}
+
+std::uint64_t LevelPack::recordAt(std::uint32_t i) const {
+  return records_[i];
+}
+
+// returns the record of level 'level', or nullptr if it's not in the pack
+const std::uint64_t* LevelPack::find(std::uint32_t level) const {
+  if (count_ == 0) {
+    return nullptr;
+  }
+  // packs usually number their levels consecutively, so try the level's own
+  // position first before searching
+  const std::uint32_t guess = level - levels_[0];
+  if (guess < count_ && levels_[guess] == level) {
+    return &records_[guess];
+  }
+  const std::uint32_t* found = std::lower_bound(levels_, levels_ + count_, level);
+  if (found == levels_ + count_ || *found != level) {
+    return nullptr;
+  }
+  return &records_[found - levels_];
+}
+
+
+
+/* HELPER or NON-MEMBER FUNCTIONS */
+
+namespace {
+
+  // returns the byte offset of the records in a pack of 'count' levels
+  std::size_t recordsOffset(std::uint32_t count) {
+    const std::size_t end_of_levels = sizeof(LevelPack::Header) + 4 * static_cast<std::size_t>(count);
+    return (end_of_levels + 7) & ~std::size_t{7};
+  }
+
+  // returns true if 'levels' is strictly ascending and every square of
+  // every record holds EMPTY or a piece type (no nibble above KING)
+  bool validContents(const std::uint32_t* levels, const std::uint64_t* records,
+                     std::uint32_t count) {
+    for (std::uint32_t i = 1; i < count; i++) {
+      if (levels[i] <= levels[i - 1]) {
+        return false;
+      }
+    }
+    // a nibble is above KING (6) if its top bit is set or its low three bits
+    // are all set; adding 1 to those low bits carries into the top bit only
+    // then, and never out of the nibble
+    std::uint64_t bad{0};
+    for (std::uint32_t i = 0; i < count; i++) {
+      bad |= records[i] | ((records[i] & 0x7777777777777777ULL) + 0x1111111111111111ULL);
+    }
+    static_assert(PieceType::KING == 6, "records hold piece types 0-6");
+    return (bad & 0x8888888888888888ULL) == 0;
+  }
+}
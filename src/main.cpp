@@ -1,11 +1,34 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 #include "../include/chessboard.hpp"
 #include "../include/coord-conversions.hpp"
+#include "../include/difficulty-rater.hpp"
+#include "../include/generator.hpp"
+#include "../include/hint-engine.hpp"
+#include "../include/level-pack.hpp"
+#include "../include/move.hpp"
+#include "../include/move-list.hpp"
+#include "../include/notation.hpp"
+#include "../include/parallel-solver.hpp"
 #include "../include/piece.hpp"
 #include "../include/piece-type-enum.hpp"
+#include "../include/puzzle-server.hpp"
+#include "../include/replay.hpp"
+#include "../include/solution-counter.hpp"
+#include "../include/solver.hpp"
+#include "../include/stats.hpp"
+#include "../include/tablebase.hpp"
 
 /* HELPER FUNCTIONS FOR MAIN*/
 
@@ -27,6 +50,20 @@ namespace {
     std::getline(std::cin, trash);
   }
 
+  // reads all of 'text' as a decimal number into 'number'; returns false,
+  // leaving 'number' alone, if 'text' is anything else or doesn't fit
+  template <typename Number>
+  bool parseNumber(std::string_view text, Number& number) {
+    Number value{};
+    const char* end = text.data() + text.size();
+    const auto [parsed_to, error] = std::from_chars(text.data(), end, value);
+    if (text.empty() || error != std::errc{} || parsed_to != end) {
+      return false;
+    }
+    number = value;
+    return true;
+  }
+
   void tutorial() {
     Chessboard ex_board{0};
     ex_board.printBoard();
@@ -73,9 +110,467 @@ namespace {
     enter_to_continue();
     std::cout << "\n\n";
   }
+
+  // prints how to run the program from the command line
+  void usage() {
+    std::cout << "usage: SolitaireChess [option]\n\n"
+              << "  (no option)      play the game interactively\n"
+              << "  --solve [level] [--threads n]\n"
+              << "                   print a solution for every level, or "
+              << "just the given one;\n"
+              << "                   n > 1 splits each search over n threads "
+              << "(0 = all cores)\n"
+              << "  --count [level]    print how many sequences of captures "
+              << "solve every level,\n"
+              << "                   or just the given one\n"
+              << "  --rate [boards]    rate how hard every level is, or every "
+              << "board in 'boards'\n"
+              << "                   (as --generate writes them), one line "
+              << "per board\n"
+              << "  --generate [--pieces n] [--mix letters | --exact letters]\n"
+              << "             [--samples n] [--seed n] [--limit n] [--retrograde]\n"
+              << "             [--unique]\n"
+              << "                   write every solvable board of n pieces "
+              << "drawn from the\n"
+              << "                   letters (PRNBQK), or of exactly the "
+              << "given pieces,\n"
+              << "                   one per line; --samples tries that many "
+              << "random boards\n"
+              << "                   instead of all of them; --retrograde "
+              << "builds that many\n"
+              << "                   boards backwards from a single piece "
+              << "instead; --unique\n"
+              << "                   keeps only boards with exactly one "
+              << "solution\n"
+              << "  --build-tablebase n [file]\n"
+              << "                   precompute the answer for every board of "
+              << "up to n pieces\n"
+              << "                   (default file: solitaire-chess.tb, "
+              << "which every other\n"
+              << "                   option loads if it's there, as does "
+              << "$SOLITAIRE_CHESS_TABLEBASE)\n"
+              << "  --batch [file]     check recorded games, one per line "
+              << "(\"<level> 2B-4C ...\"),\n"
+              << "                   read from the file or stdin, printing "
+              << "one result per game\n"
+              << "  --write-levelpack file [boards]\n"
+              << "                   write the built-in levels, or the boards "
+              << "in 'boards' (as\n"
+              << "                   --generate writes them, numbered from 1), "
+              << "as a level pack\n"
+              << "  --serve path [--threads n]\n"
+              << "                   answer SOLVE, VALIDATE, HINT and LEVEL "
+              << "requests, one per\n"
+              << "                   line, on the Unix socket 'path' until "
+              << "interrupted, with n\n"
+              << "                   threads (default: all cores)\n"
+              << "  --levels file      (with any of the above, or alone) use "
+              << "the levels of a\n"
+              << "                   level pack instead of the built-in ones\n"
+              << "  --stats[=json]     (with any of the above, or alone) print "
+              << "what the run did\n"
+              << "                   (moves generated, nodes searched, time "
+              << "per phase) to stderr\n"
+              << "                   on exit; only in builds configured with\n"
+              << "                   -DSOLITAIRE_CHESS_STATS=ON, any other "
+              << "build rejects it\n";
+  }
+
+  // writes the counters to stderr as the "--stats" or "--stats=json" option
+  // 'stats_option' asks for (nothing if it's empty)
+  void reportStats(const std::string& stats_option) {
+    if (stats_option == "--stats=json") {
+      Stats::writeJson(Stats::snapshot(), std::cerr);
+    } else if (!stats_option.empty()) {
+      Stats::writeTable(Stats::snapshot(), std::cerr);
+    }
+  }
+
+  // prints a solution for every level of 'level_pack' from 'first' to
+  // 'last', with the time
+  // the solver took for each; 'threads' > 1 splits each search over that many
+  // threads (0 meaning one per hardware thread)
+  // returns 0 if every level was solvable, 1 otherwise
+  int solveLevels(std::uint32_t first, std::uint32_t last, unsigned threads,
+                  const Tablebase& tablebase, const LevelPack& level_pack) {
+    Solver solver;
+    solver.setTablebase(&tablebase);
+    std::optional<ParallelSolver> parallel_solver;
+    if (threads != 1) {
+      parallel_solver.emplace(threads);
+    }
+    int status{0};
+    for (std::uint32_t i = 0; i < level_pack.size(); i++) {
+      const std::uint32_t level = level_pack.levelAt(i);
+      if (level < first || level > last) {
+        continue;
+      }
+      const Chessboard board = Chessboard::fromPacked(level_pack.recordAt(i));
+      const auto start = std::chrono::steady_clock::now();
+      const std::optional<std::vector<Move>> solution{
+          parallel_solver ? parallel_solver->solve(board) : solver.solve(board)};
+      const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start);
+
+      std::cout << "level " << level << ":";
+      if (solution) {
+        for (const Move& move : *solution) {
+          std::cout << " " << moveToDisplay(move);
+        }
+      } else {
+        std::cout << " no solution";
+        status = 1;
+      }
+      std::cout << " (" << elapsed.count() << " us)\n";
+    }
+    return status;
+  }
+
+  // prints how many sequences of captures solve every level of 'level_pack'
+  // from 'first' to 'last'
+  // returns 0 if every level was solvable, 1 otherwise
+  int countSolutions(std::uint32_t first, std::uint32_t last, const Tablebase& tablebase,
+                     const LevelPack& level_pack) {
+    SolutionCounter counter;
+    counter.setTablebase(&tablebase);
+    int status{0};
+    for (std::uint32_t i = 0; i < level_pack.size(); i++) {
+      const std::uint32_t level = level_pack.levelAt(i);
+      if (level < first || level > last) {
+        continue;
+      }
+      const std::uint64_t solutions =
+          counter.count(Chessboard::fromPacked(level_pack.recordAt(i)));
+      std::cout << "level " << level << ": " << solutions
+                << (solutions >= SolutionCounter::kMaxCount ? " or more" : "")
+                << (solutions == 1 ? " solution\n" : " solutions\n");
+      if (solutions == 0) {
+        status = 1;
+      }
+    }
+    return status;
+  }
+
+  // prints how hard every level of 'level_pack' is, with the figures the
+  // rating comes from
+  int rateLevels(const LevelPack& level_pack) {
+    DifficultyRater rater;
+    for (std::uint32_t i = 0; i < level_pack.size(); i++) {
+      const DifficultyRater::Rating rating =
+          rater.rate(Chessboard::fromPacked(level_pack.recordAt(i)));
+      std::cout << "level " << level_pack.levelAt(i) << ": "
+                << DifficultyRater::gradeName(rating.grade) << " (score " << rating.score
+                << "; " << rating.tree_size << " positions in the capture tree, "
+                << rating.branching << " captures per position, "
+                << rating.dead_end_ratio << " dead ends per solution, a losing capture "
+                << "possible after " << rating.first_mistake << " captures)\n";
+    }
+    return 0;
+  }
+
+  // rates every board in the file at 'path' (one per line, in Notation) and
+  // writes one line per board to stdout:
+  //   "<board> <grade> <score> <tree size> <branching> <dead ends per
+  //   solution> <first mistake>"
+  // buffered so it's written in large blocks; a summary goes to stderr
+  int rateBoards(const std::string& path) {
+    PositionReader reader;
+    if (!reader.open(path)) {
+      std::cerr << "error: couldn't read boards from " << path << ".\n";
+      return 1;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    // a file of boards walks far more positions than the levels do, so the
+    // rater gets the generator's memory budget
+    DifficultyRater rater{64 * 1024};
+    std::string results;
+    results.reserve(1 << 16);
+    std::uint64_t boards{0};
+    for (std::uint64_t packed; reader.next(packed); boards++) {
+      const DifficultyRater::Rating rating = rater.rate(Chessboard::fromPacked(packed));
+      Notation::append(packed, results);
+      char figures[96];
+      std::snprintf(figures, sizeof(figures), " %s %.2f %llu %.2f %.2f %d\n",
+                    DifficultyRater::gradeName(rating.grade), rating.score,
+                    static_cast<unsigned long long>(rating.tree_size), rating.branching,
+                    rating.dead_end_ratio, rating.first_mistake);
+      results += figures;
+      if (results.size() >= (1 << 16) - 128) {
+        std::cout.write(results.data(), static_cast<std::streamsize>(results.size()));
+        results.clear();
+      }
+    }
+    std::cout.write(results.data(), static_cast<std::streamsize>(results.size()));
+    std::cout.flush();
+
+    const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cerr << boards << " boards rated (" << rater.getNodes()
+              << " positions walked) in " << seconds << " s, "
+              << static_cast<std::uint64_t>(boards / seconds) << " boards/s\n";
+    if (reader.getErrors() != 0) {
+      std::cerr << reader.getErrors() << " lines of " << path
+                << " weren't positions and were skipped\n";
+    }
+    return 0;
+  }
+
+  // returns the value following 'option' in 'args', or 'fallback' if the
+  // option wasn't given
+  std::string optionValue(const std::vector<std::string>& args,
+                          const std::string& option, const std::string& fallback) {
+    for (std::size_t i = 0; i + 1 < args.size(); i++) {
+      if (args[i] == option) {
+        return args[i + 1];
+      }
+    }
+    return fallback;
+  }
+
+  // reads 'text', given for 'what' on the command line, as a number into
+  // 'number'; returns false, after saying what was wrong and printing the
+  // usage, if it isn't one
+  template <typename Number>
+  bool readNumber(const std::string& text, const char* what, Number& number) {
+    if (parseNumber(text, number)) {
+      return true;
+    }
+    std::cerr << "error: " << what << " must be a number, not \"" << text << "\".\n";
+    usage();
+    return false;
+  }
+
+  // runs the puzzle generator with the options in 'args', writing solvable
+  // boards to stdout and a summary to stderr
+  int generatePuzzles(const std::vector<std::string>& args, const Tablebase& tablebase) {
+    Generator::Options options;
+    if (!readNumber(optionValue(args, "--pieces", "4"), "--pieces", options.pieces) ||
+        !readNumber(optionValue(args, "--samples", "0"), "--samples", options.samples) ||
+        !readNumber(optionValue(args, "--seed", "1"), "--seed", options.seed) ||
+        !readNumber(optionValue(args, "--limit", "0"), "--limit", options.limit)) {
+      return 1;
+    }
+    options.mix = optionValue(args, "--mix", "PRNBQK");
+    if (const std::string exact = optionValue(args, "--exact", ""); !exact.empty()) {
+      options.mix = exact;
+      options.exact_mix = true;
+    }
+    options.retrograde =
+        std::find(args.begin(), args.end(), "--retrograde") != args.end();
+    options.unique = std::find(args.begin(), args.end(), "--unique") != args.end();
+
+    const auto start = std::chrono::steady_clock::now();
+    Generator generator{options};
+    generator.setTablebase(&tablebase);
+    const std::uint64_t found = generator.run(std::cout);
+    const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::cerr << found << (options.unique ? " uniquely" : "") << " solvable of " << generator.getCandidates()
+              << " boards " << (options.retrograde ? "built" : "checked")
+              << " (" << generator.getDuplicates()
+              << " symmetric images skipped) in " << seconds << " s, "
+              << static_cast<std::uint64_t>(generator.getCandidates() / seconds)
+              << " boards/s\n";
+    return 0;
+  }
+
+  // checks every game in 'in' (one per line, see Replay, levels taken from
+  // 'level_pack') and writes one
+  // result line per game to stdout, buffered so it's written in large blocks
+  // returns 0 if every game was solved, 1 otherwise
+  int replayGames(std::istream& in, const LevelPack& level_pack) {
+    STATS_PHASE(Stats::BATCH);
+    std::ios::sync_with_stdio(false);
+    std::string game, results;
+    results.reserve(1 << 16);
+    int status{0};
+    while (std::getline(in, game)) {
+      const Replay::Result result = Replay::validateLine(game, level_pack);
+      if (result.status != Replay::Status::SOLVED) {
+        status = 1;
+      }
+      Replay::appendResult(result, results);
+      if (results.size() >= (1 << 16) - 64) {
+        std::cout.write(results.data(), static_cast<std::streamsize>(results.size()));
+        results.clear();
+      }
+    }
+    std::cout.write(results.data(), static_cast<std::streamsize>(results.size()));
+    std::cout.flush();
+    return status;
+  }
+
+  // writes the built-in levels, or the positions in 'args[2]' (one per line,
+  // in Notation), as a level pack at 'args[1]'
+  int writeLevelPack(const std::vector<std::string>& args) {
+    std::vector<std::pair<std::uint32_t, std::uint64_t>> levels;
+    if (args.size() >= 3) {
+      PositionReader reader;
+      if (!reader.open(args[2])) {
+        std::cerr << "error: couldn't read boards from " << args[2] << ".\n";
+        return 1;
+      }
+      for (std::uint64_t packed; reader.next(packed);) {
+        levels.push_back({static_cast<std::uint32_t>(levels.size() + 1), packed});
+      }
+      if (reader.getErrors() != 0) {
+        std::cerr << reader.getErrors() << " lines of " << args[2]
+                  << " weren't positions and were skipped\n";
+      }
+    } else {
+      const LevelPack& builtin = LevelPack::builtin();
+      for (std::uint32_t i = 0; i < builtin.size(); i++) {
+        levels.push_back({builtin.levelAt(i), builtin.recordAt(i)});
+      }
+    }
+    if (!LevelPack::write(levels, args[1])) {
+      return 1;
+    }
+    std::cerr << levels.size() << " levels written to " << args[1] << "\n";
+    return 0;
+  }
+
+  // the running server, for the signal handler that stops it
+  PuzzleServer* running_server{nullptr};
+
+  // answers requests on the Unix socket 'path' until SIGINT or SIGTERM
+  // arrives, with 'threads' threads (0 meaning one per hardware thread)
+  int servePuzzles(const std::string& path, unsigned threads, const Tablebase& tablebase,
+                   const LevelPack& level_pack) {
+    PuzzleServer server{level_pack, tablebase, threads};
+    if (!server.listen(path)) {
+      return 1;
+    }
+    running_server = &server;
+    const auto stop = [](int) { running_server->stop(); };
+    std::signal(SIGINT, stop);
+    std::signal(SIGTERM, stop);
+    std::cerr << "serving on " << path << "\n";
+    server.run();
+    // the handlers go before the pointer they use, so a signal arriving
+    // while the server shuts down never finds it cleared
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    running_server = nullptr;
+    return 0;
+  }
+
+  // runs the non-interactive mode named by the command-line arguments, with
+  // levels taken from 'level_pack'
+  // returns the program's exit status
+  int runCommand(const std::vector<std::string>& args, const LevelPack& level_pack) {
+    // a prebuilt tablebase, if there is one, answers small boards instantly
+    Tablebase tablebase;
+    tablebase.openDefault();
+
+    if (args[0] == "--solve") {
+      unsigned threads{1};
+      if (!readNumber(optionValue(args, "--threads", "1"), "--threads", threads)) {
+        return 1;
+      }
+      if (args.size() == 1 || args[1].rfind("--", 0) == 0) {
+        // every level but the tutorial's example, or every level of a pack
+        const std::uint32_t first = &level_pack == &LevelPack::builtin() ? 1 : 0;
+        return solveLevels(first, UINT32_MAX, threads, tablebase, level_pack);
+      }
+      std::uint32_t level{0};
+      if (!readNumber(args[1], "the level", level)) {
+        return 1;
+      }
+      return solveLevels(level, level, threads, tablebase, level_pack);
+    }
+    if (args[0] == "--count") {
+      if (args.size() == 1) {
+        const std::uint32_t first = &level_pack == &LevelPack::builtin() ? 1 : 0;
+        return countSolutions(first, UINT32_MAX, tablebase, level_pack);
+      }
+      std::uint32_t level{0};
+      if (!readNumber(args[1], "the level", level)) {
+        return 1;
+      }
+      return countSolutions(level, level, tablebase, level_pack);
+    }
+    if (args[0] == "--rate") {
+      return args.size() >= 2 ? rateBoards(args[1]) : rateLevels(level_pack);
+    }
+    if (args[0] == "--generate") {
+      return generatePuzzles(args, tablebase);
+    }
+    if (args[0] == "--build-tablebase" && args.size() >= 2) {
+      const std::string path = args.size() >= 3 ? args[2] : "solitaire-chess.tb";
+      int pieces{0};
+      if (!readNumber(args[1], "the number of pieces", pieces)) {
+        return 1;
+      }
+      return Tablebase::build(pieces, path) ? 0 : 1;
+    }
+    if (args[0] == "--batch") {
+      if (args.size() == 1 || args[1] == "-") {
+        return replayGames(std::cin, level_pack);
+      }
+      std::ifstream file{args[1]};
+      if (!file) {
+        std::cerr << "error: couldn't read " << args[1] << ".\n";
+        return 1;
+      }
+      return replayGames(file, level_pack);
+    }
+    if (args[0] == "--serve" && args.size() >= 2) {
+      unsigned threads{0};
+      if (!readNumber(optionValue(args, "--threads", "0"), "--threads", threads)) {
+        return 1;
+      }
+      return servePuzzles(args[1], threads, tablebase, level_pack);
+    }
+    if (args[0] == "--write-levelpack" && args.size() >= 2) {
+      return writeLevelPack(args);
+    }
+    usage();
+    return args[0] == "--help" ? 0 : 1;
+  }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+  std::vector<std::string> args(argv + 1, argv + argc);
+
+  // "--levels file" plays (or solves, or checks games against) the levels of
+  // a level pack instead of the built-in ones
+  LevelPack custom_pack;
+  const LevelPack* level_pack = &LevelPack::builtin();
+  if (const auto option = std::find(args.begin(), args.end(), "--levels");
+      option != args.end()) {
+    if (option + 1 == args.end() || !custom_pack.open(*(option + 1))) {
+      std::cerr << "error: couldn't open level pack.\n";
+      return 1;
+    }
+    level_pack = &custom_pack;
+    args.erase(option, option + 2);
+  }
+  // "--stats" reports what the run did once it's over
+  std::string stats_option;
+  if (const auto option = std::find_if(args.begin(), args.end(), [](const std::string& arg) {
+        return arg == "--stats" || arg == "--stats=json";
+      });
+      option != args.end()) {
+    // a build without the counters would only report zeros, so say why
+    // instead of running without them
+    if (!Stats::kEnabled) {
+      std::cerr << "error: " << *option << " needs a build configured with "
+                << "-DSOLITAIRE_CHESS_STATS=ON.\n";
+      return 1;
+    }
+    stats_option = *option;
+    args.erase(option);
+  }
+
+  // any other command-line option skips the interactive game
+  if (!args.empty()) {
+    const int status = runCommand(args, *level_pack);
+    reportStats(stats_option);
+    return status;
+  }
+
   // explain rules to user
   std::cout << line << "\t\t\t    SOLITAIRE CHESS\n" << line;
   std::cout << "Solitaire Chess is a one-player game with chess pieces and "
@@ -96,6 +591,13 @@ int main() {
   // setting default val. for level
   int level{ 1 };
 
+  // answers "h" in the move loop, and warns as soon as a move makes the
+  // level unwinnable
+  Tablebase tablebase;
+  tablebase.openDefault();
+  HintEngine hints;
+  hints.setTablebase(&tablebase);
+
   while (true) { // LOOP1: this loop contains whole operation of game
     // print main menu
     std::cout << line << "\t\t\t      LEVEL SELECT\n" << line;
@@ -103,8 +605,13 @@ int main() {
               << "Intermediate:\n\t[ 6] [ 7] [ 8] [ 9] [10]\n\n"
               << "Advanced:\n\t[11] [12] [13] [14] [15]\n\n"
               << "Expert:\n\t[16] [17] [18] [19] [20]\n\n"
-              << line << "\t\t\t\tQUIT ('q')\n" << line
-              << "\nEnter the number of the level you'd like to enter,\nor "
+              << line << "\t\t\t\tQUIT ('q')\n" << line;
+    if (level_pack != &LevelPack::builtin() && level_pack->size() != 0) {
+      std::cout << "\nThe level pack has " << level_pack->size() << " levels, numbered "
+                << level_pack->levelAt(0) << " to "
+                << level_pack->levelAt(level_pack->size() - 1) << ".\n";
+    }
+    std::cout << "\nEnter the number of the level you'd like to enter,\nor "
               << "enter \"q\" to quit: ";
     std::string lvl_choice;
     std::getline(std::cin, lvl_choice);
@@ -117,27 +624,26 @@ int main() {
       continue;
     } else if ((lvl_choice[0] == 'q') || (lvl_choice[0] == 'Q')) {
       break;
-      // if the first char in lvl_choice is a digit between 1 and 9, inclusive
-    } else if (std::isdigit(lvl_choice[0]) && (lvl_choice[0] > 48) &&
-                (lvl_choice[0] < 58)) {
-      level = std::stoi(lvl_choice.substr(0,1));
-      // if lvl_choice is longer than 1 AND a digit AND either:
-      //  (level is currently 1 AND the 2nd char in lvl_choice is between 0
-      //  and 9, inclusive) OR
-      //  (level is currently 2 AND the 2nd char in lvl_choice is 0)
-      if ((lvl_choice.size() > 1) && std::isdigit(lvl_choice.at(1)) &&
-          (((level == 1) && (lvl_choice.at(1) > 47) &&
-            (lvl_choice.at(1) < 58)) ||
-            ((level == 2) && (lvl_choice.at(1) == 48)))) {
-        level = std::stoi(lvl_choice.substr(0,2));
-      }
+      // any level number the level pack might hold (spaces after it ignored)
+    } else if (std::uint32_t choice{0};
+               parseNumber(std::string_view{lvl_choice}.substr(
+                               0, lvl_choice.find_last_not_of(" \t\r") + 1),
+                           choice) &&
+               choice <= static_cast<std::uint32_t>(INT32_MAX)) {
+      level = static_cast<int>(choice);
     } else {
       std::cout << "Please try again.\n\n";
       enter_to_continue();
       continue;
     }
+    // a level pack doesn't have to hold every level
+    if (level_pack->find(level) == nullptr) {
+      std::cout << "That level isn't in the level pack. Please try again.\n\n";
+      enter_to_continue();
+      continue;
+    }
     // creates Chessboard object with user's given level
-    Chessboard board{ level };
+    Chessboard board{ level, *level_pack };
     bool is_first_move{ true };
 
     while (true) { // LOOP 2: this loop contains each move (move loop)
@@ -148,9 +654,18 @@ int main() {
       std::cout << "\nEnter the coordinate of the piece you'd like to move "
                 << "(enter coordinate in \"1A\" format),";
       if (is_first_move) {
-        std::cout << "\nor \"b\" to go back to main menu: ";
+        std::cout << "\n\"h\" for a hint, or \"b\" to go back to main menu: ";
       } else {
-        std::cout << "\n\"b\" to go back to main menu, or \"r\" to restart: ";
+        std::cout << "\n\"h\" for a hint, \"b\" to go back to main menu, "
+                  << "\"r\" to restart";
+        // offers to take back / replay a move only when there's one to
+        if (board.canUndo()) {
+          std::cout << ", \"u\" to undo";
+        }
+        if (board.canRedo()) {
+          std::cout << ", \"y\" to redo";
+        }
+        std::cout << ": ";
       }
       // gets the users response (as a std::string) to the above prompt
       // (using getline so that it doesn't break if they put a space)
@@ -179,12 +694,47 @@ int main() {
           // ^if this is not the first move in the level,
           // AND if the first character in the user's input is 'r' or 'R'...
 
-        // makes a new Chessboard obj that is the same setup at the beginning of
-        // 'level' (which's the level the user's currently on)...
-        Chessboard new_board{ level };
-        // and sets board equal to that board, resetting the board to how it was
-        // in the beginning of the level
-        board = new_board;
+        // takes back every move made, resetting the board to how it was in
+        // the beginning of the level
+        while (board.undo()) {}
+        // goes back to beginning of LOOP 2
+        continue;
+      } else if ((user_choice[0] == 'h') || (user_choice[0] == 'H')) {
+          // ^if first character of user's input is 'h' or 'H'...
+        // suggests a capture that still wins, if there is one
+        const HintEngine::Hint hint = hints.hint(board);
+        if (hint.status == HintEngine::Status::WINNING) {
+          std::cout << "Hint: move the "
+                    << board[static_cast<int>(hint.move.from)].getName() << " at "
+                    << Coords::coordToDisplay(Coords::indexToCoord(hint.move.from))
+                    << " to "
+                    << Coords::coordToDisplay(Coords::indexToCoord(hint.move.to))
+                    << ".\n\n";
+        } else if (hint.status == HintEngine::Status::UNSOLVABLE) {
+          std::cout << "There's no way to win from here any more. Try \"u\" to "
+                    << "undo or \"r\" to restart.\n\n";
+        } else {
+          std::cout << "Sorry, no hint could be found in time.\n\n";
+        }
+        enter_to_continue();
+        // goes back to beginning of LOOP 2
+        continue;
+      } else if ((user_choice[0] == 'u') || (user_choice[0] == 'U')) {
+          // ^if first character of user's input is 'u' or 'U'...
+        // takes back the last move, if there is one
+        if (!board.undo()) {
+          std::cout << "There's no move to undo.\n\n";
+          enter_to_continue();
+        }
+        // goes back to beginning of LOOP 2
+        continue;
+      } else if ((user_choice[0] == 'y') || (user_choice[0] == 'Y')) {
+          // ^if first character of user's input is 'y' or 'Y'...
+        // plays the last move taken back again, if there is one
+        if (!board.redo()) {
+          std::cout << "There's no move to redo.\n\n";
+          enter_to_continue();
+        }
         // goes back to beginning of LOOP 2
         continue;
       } else if ((user_choice[0] == 'b') || (user_choice[0] == 'B')) {
@@ -208,7 +758,7 @@ int main() {
           // selected coordinate on the board
           piece_name = board[initial_spot].getName();
           // if selected piece has no moves...
-          if (board.getMoves(initial_spot).empty()) {
+          if (!board.hasMoves(initial_spot)) {
             // explain that this piece has no moves and ask them to try again
             std::cout << "Sorry, it seems the piece you selected has no moves "
                       << "in which it attacks another piece.\n"
@@ -268,9 +818,9 @@ int main() {
         std::cout << "\nMove options for your " << piece_name << ":\n\n";
 
         // stores the possible moves the Piece obj at 'initial_spot' can make
-        // in the vector of int-int pairs 'moves'
-        const std::vector<std::pair<int, int>> moves{
-            board.getMoves(initial_spot)};
+        // in the stack-allocated list 'moves'
+        MoveList moves;
+        board.getMoves(Coords::coordToIndex(initial_spot), moves);
 
         // lists out numbers 1-n, n being the amount of moves the piece can make
         // (this's so that the user can enter the number under which the
@@ -281,9 +831,10 @@ int main() {
           std::cout << "[" << i << "] ";
         }
         std::cout << "\n";
-        // lists each coordinate in 'moves' vector underneath the listed numbers
-        for (const std::pair<int, int>& coord : moves) {
-          std::cout << " " << Coords::coordToDisplay(coord) << " ";
+        // lists each coordinate in 'moves' list underneath the listed numbers
+        for (const Move& move : moves) {
+          std::cout << " " << Coords::coordToDisplay(Coords::indexToCoord(move.to))
+                    << " ";
         }
         std::cout << "\n\nPlease enter the digit above the coordinate you'd "
                   << "like to move your piece to: ";
@@ -312,23 +863,16 @@ int main() {
             (std::stoi(mv_choice) <= moves.size())) {
           // an int-int pair that is the coordinate that the user selected to
           // be their selected piece's new spot to move to
-          std::pair<int, int> new_spot{ moves.at(std::stoi(mv_choice) - 1) };
+          std::pair<int, int> new_spot{
+              Coords::indexToCoord(moves[std::stoi(mv_choice) - 1].to) };
           // updates the Chessboard obj 'board' so that the piece currently at
           // 'initial_spot' is moved to 'new_spot',
           // 'initial_spot' then being filled with an empty Piece obj;
           // this is basically a piece taking another piece
           board.updateBoard(initial_spot, new_spot);
 
-          // counts how many pieces are on the board
-          int counter{0};
-          for (const Piece& piece : board.getBoard()) {
-            if (piece.getPieceType() != 0) {
-              counter++;
-            }
-          }
-
           // if there's only one piece left on the board...
-          if (counter == 1) {
+          if (board.pieceCount() == 1) {
             // display board one last time
             board.printBoard();
             std::cout << "\nCongratulations! You beat this level!\n\n";
@@ -344,6 +888,11 @@ int main() {
           // their selected new position
           std::cout << "You decided to move your " << piece_name << " to "
                     << Coords::coordToDisplay(new_spot) << ".\n\n";
+          // tells the user straight away if that move lost the level
+          if (hints.hint(board).status == HintEngine::Status::UNSOLVABLE) {
+            std::cout << "There's no way to win from here any more. Try \"u\" "
+                      << "to undo or \"r\" to restart.\n\n";
+          }
           // halts progression till user presses 'enter'
           enter_to_continue();
           //
@@ -367,5 +916,6 @@ int main() {
     }
   }
 
+  reportStats(stats_option);
   return 0;
 }
@@ -0,0 +1,10 @@
+#include <string>
+
+#include "../include/coord-conversions.hpp"
+#include "../include/move.hpp"
+
+// converts a move to "1A-2B" format
+std::string moveToDisplay(const Move& move) {
+  return Coords::coordToDisplay(Coords::indexToCoord(move.from)) + "-" +
+         Coords::coordToDisplay(Coords::indexToCoord(move.to));
+}
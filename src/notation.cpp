@@ -0,0 +1,239 @@
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../include/notation.hpp"
+
+namespace {
+  // the piece type of every byte, or -1; '.' is handled by the parser
+  constexpr std::array<std::int8_t, 256> makeLetterTable() {
+    std::array<std::int8_t, 256> table{};
+    for (std::int8_t& entry : table) {
+      entry = -1;
+    }
+    for (int piece_type = PieceType::PAWN; piece_type <= PieceType::KING; piece_type++) {
+      const char letter = Notation::kLetters[piece_type];
+      table[static_cast<unsigned char>(letter)] = static_cast<std::int8_t>(piece_type);
+      table[static_cast<unsigned char>(letter | 0x20)] = static_cast<std::int8_t>(piece_type);
+    }
+    return table;
+  }
+  constexpr std::array<std::int8_t, 256> kTypeOfLetter{makeLetterTable()};
+
+  // what the parser does with each byte: the piece type it places, how many
+  // squares it moves on, and whether it ends a rank or the whole position
+  // an invalid byte moves on 7 squares, more than a rank holds, so it always
+  // leaves the rank with the wrong number of squares
+  constexpr std::uint8_t kTypeBits{0x7};
+  constexpr int kAdvanceShift{3};
+  constexpr std::uint8_t kAdvanceBits{0x7 << kAdvanceShift};
+  constexpr std::uint8_t kSlash{1 << 6};
+  constexpr std::uint8_t kStop{1 << 7};
+  constexpr std::array<std::uint8_t, 256> makeCharInfo() {
+    std::array<std::uint8_t, 256> table{};
+    for (int c = 0; c < 256; c++) {
+      if (kTypeOfLetter[c] > 0) {
+        table[c] = static_cast<std::uint8_t>(kTypeOfLetter[c] | (1 << kAdvanceShift));
+      } else if (c >= '1' && c <= '4') {
+        table[c] = static_cast<std::uint8_t>((c - '0') << kAdvanceShift);
+      } else if (c == '.') {
+        table[c] = 1 << kAdvanceShift;
+      } else if (c == '/') {
+        table[c] = kSlash;
+      } else if (c == ' ' || c == '\t' || c == '\r') {
+        table[c] = kStop;
+      } else {
+        table[c] = kAdvanceBits;
+      }
+    }
+    return table;
+  }
+  constexpr std::array<std::uint8_t, 256> kCharInfo{makeCharInfo()};
+
+  // files are read in blocks this large; a line longer than that is invalid
+  constexpr std::size_t kBlockSize{1 << 20};
+}
+
+namespace Notation {
+  // returns the letter of 'piece_type'
+  char typeToLetter(PieceType::PieceType piece_type) {
+    return piece_type >= PieceType::EMPTY && piece_type <= PieceType::KING
+               ? kLetters[piece_type] : '?';
+  }
+
+  // returns the piece type written as 'letter' (either case), or -1 if it
+  // isn't a piece letter
+  int letterToType(char letter) {
+    return kTypeOfLetter[static_cast<unsigned char>(letter)];
+  }
+
+  // reads the position at the start of 'text' into 'packed'; returns false
+  // (leaving 'packed' alone) if it isn't a valid position
+  // every byte is handled the same way, through kCharInfo, and a bad rank is
+  // noted rather than branched on, so positions of any shape parse without
+  // mispredicted branches
+  bool parse(std::string_view text, std::uint64_t& packed) {
+    std::uint64_t result{0};
+    int square{0}, rank_end{4};
+    bool bad{false};
+    for (const char c : text) {
+      const std::uint8_t info = kCharInfo[static_cast<unsigned char>(c)];
+      if (info & kStop) {
+        break;
+      }
+      // every rank must end exactly on its fourth square
+      const bool slash = (info & kSlash) != 0;
+      bad |= slash & (square != rank_end);
+      rank_end += 4 * slash;
+      result |= static_cast<std::uint64_t>(info & kTypeBits) << (4 * (square & 15));
+      square += (info & kAdvanceBits) >> kAdvanceShift;
+    }
+    if (bad || square != 16 || rank_end != 16) {
+      return false;
+    }
+    packed = result;
+    return true;
+  }
+
+  // writes the position 'packed' to 'out' (at least kMaxLength chars, not
+  // null-terminated); returns the number of characters written
+  std::size_t write(std::uint64_t packed, char* out) {
+    char* at = out;
+    for (int rank = 0; rank < 4; rank++) {
+      if (rank != 0) {
+        *at++ = '/';
+      }
+      char empty{0};
+      for (int file = 0; file < 4; file++) {
+        const auto piece_type =
+            static_cast<PieceType::PieceType>((packed >> (4 * (4 * rank + file))) & 0xF);
+        if (piece_type == PieceType::EMPTY) {
+          empty++;
+          continue;
+        }
+        if (empty != 0) {
+          *at++ = static_cast<char>('0' + empty);
+          empty = 0;
+        }
+        *at++ = typeToLetter(piece_type);
+      }
+      if (empty != 0) {
+        *at++ = static_cast<char>('0' + empty);
+      }
+    }
+    return static_cast<std::size_t>(at - out);
+  }
+
+  // appends the position 'packed' to 'out'
+  void append(std::uint64_t packed, std::string& out) {
+    char text[kMaxLength];
+    out.append(text, write(packed, text));
+  }
+
+  // returns the position 'packed' as text
+  std::string toString(std::uint64_t packed) {
+    std::string text;
+    append(packed, text);
+    return text;
+  }
+}
+
+
+/* MEMBER FUNCTIONS */
+
+// reads from stdin
+PositionReader::PositionReader() : buffer_(kBlockSize) {}
+
+PositionReader::~PositionReader() {
+  if (fd_ > 0) {
+    ::close(fd_);
+  }
+}
+
+// reads from the file at 'path' ("-" meaning stdin); returns false if it
+// can't be opened
+bool PositionReader::open(const std::string& path) {
+  const int fd = path == "-" ? 0 : ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  if (fd_ > 0) {
+    ::close(fd_);
+  }
+  fd_ = fd;
+  begin_ = end_ = 0;
+  eof_ = skipping_ = false;
+  line_ = errors_ = 0;
+  return true;
+}
+
+// reads the next position into 'packed'; returns false at the end
+bool PositionReader::next(std::uint64_t& packed) {
+  while (true) {
+    const char* start = buffer_.data() + begin_;
+    const auto* newline =
+        static_cast<const char*>(std::memchr(start, '\n', end_ - begin_));
+    if (newline == nullptr && !eof_) {
+      // a line longer than a whole block can't be a position; its start is
+      // dropped here and the rest when its newline turns up
+      if (end_ - begin_ == buffer_.size()) {
+        begin_ = end_ = 0;
+        skipping_ = true;
+      }
+      refill();
+      continue;
+    }
+    if (newline == nullptr && begin_ == end_) {
+      return false;
+    }
+
+    // the last line of a file may not end in a newline
+    const std::size_t length =
+        newline != nullptr ? static_cast<std::size_t>(newline - start) : end_ - begin_;
+    begin_ += newline != nullptr ? length + 1 : length;
+    line_++;
+    if (skipping_) {
+      skipping_ = false;
+      errors_++;
+      continue;
+    }
+    if (length == 0 || start[0] == '#' || (length == 1 && start[0] == '\r')) {
+      continue;
+    }
+    if (Notation::parse(std::string_view{start, length}, packed)) {
+      return true;
+    }
+    errors_++;
+  }
+}
+
+// returns the number of the line the last position came from (from 1)
+std::uint64_t PositionReader::getLine() const {
+  return line_;
+}
+
+// returns the number of lines skipped as invalid
+std::uint64_t PositionReader::getErrors() const {
+  return errors_;
+}
+
+// moves the unread bytes to the front of the buffer and reads more, until
+// it holds a whole line or the file is exhausted
+void PositionReader::refill() {
+  std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+  end_ -= begin_;
+  begin_ = 0;
+  while (end_ < buffer_.size()) {
+    const ssize_t count = ::read(fd_, buffer_.data() + end_, buffer_.size() - end_);
+    if (count <= 0) {
+      eof_ = true;
+      return;
+    }
+    end_ += static_cast<std::size_t>(count);
+    // a partial read (e.g. from a pipe) already holds whole lines
+    if (std::memchr(buffer_.data() + end_ - count, '\n', count) != nullptr) {
+      return;
+    }
+  }
+}
@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <thread>
+
+#include "../include/attack-tables.hpp"
+#include "../include/chessboard.hpp"
+#include "../include/move.hpp"
+#include "../include/parallel-solver.hpp"
+#include "../include/stats.hpp"
+#include "../include/transposition-table.hpp"
+
+
+/* MEMBER FUNCTIONS */
+
+// constructor for the parallel solver
+ParallelSolver::ParallelSolver(unsigned threads, int table_bits)
+    : threads_(threads != 0 ? threads
+                            : std::max(1u, std::thread::hardware_concurrency())),
+      dead_(new std::atomic<std::uint64_t>[std::size_t{1} << table_bits]),
+      dead_mask_((std::uint64_t{1} << table_bits) - 1),
+      dead_shift_(64 - table_bits) {
+  for (std::uint64_t i = 0; i <= dead_mask_; i++) {
+    dead_[i].store(0, std::memory_order_relaxed);
+  }
+  for (unsigned i = 0; i < threads_; i++) {
+    queues_.push_back(std::make_unique<WorkQueue>());
+  }
+}
+
+// returns the captures that solve 'board', in order, or std::nullopt if the
+// board can't be solved
+std::optional<std::vector<Move>> ParallelSolver::solve(const Chessboard& board) {
+  STATS_PHASE(Stats::SOLVE);
+  if (board.pieceCount() == 0) {
+    return std::nullopt;
+  }
+
+  found_.store(false);
+  solution_.clear();
+  pending_.store(1);
+  pushTask(0, Task{board, {}, 0});
+
+  std::vector<std::thread> workers;
+  for (unsigned id = 1; id < threads_; id++) {
+    workers.emplace_back(&ParallelSolver::work, this, id);
+  }
+  work(0);
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  // a cancelled search can leave tasks behind
+  for (const std::unique_ptr<WorkQueue>& queue : queues_) {
+    queue->tasks.clear();
+  }
+
+  if (!found_.load()) {
+    return std::nullopt;
+  }
+  return solution_;
+}
+
+std::uint64_t ParallelSolver::getNodes() const {
+  return nodes_.load();
+}
+
+unsigned ParallelSolver::getThreads() const {
+  return threads_;
+}
+
+// runs tasks on thread 'id' until a solution is found or no work is left
+void ParallelSolver::work(unsigned id) {
+  std::uint64_t nodes{0};
+  Task task{Chessboard{}, {}, 0};
+
+  while (!found_.load(std::memory_order_relaxed) &&
+         pending_.load(std::memory_order_acquire) > 0) {
+    if (!popTask(id, task)) {
+      std::this_thread::yield();
+      continue;
+    }
+
+    const std::uint16_t occ = task.board.getOccupancy();
+    if (task.depth >= split_depth_ || (occ & (occ - 1)) == 0) {
+      // deep enough that splitting further isn't worth it
+      if (search(task, nodes)) {
+        publish(task);
+      }
+    } else {
+      // splits the node into one task per capture
+      nodes++;
+      for (std::uint16_t pieces = occ; pieces != 0; pieces &= pieces - 1) {
+        const int from = __builtin_ctz(pieces);
+        for (std::uint16_t captures = Attacks::captures(task.board.typeAt(from), from, occ);
+             captures != 0; captures &= captures - 1) {
+          const int to = __builtin_ctz(captures);
+          Task child = task;
+          child.board.makeMove(from, to);
+          if (isDead(child.board)) {
+            continue;
+          }
+          child.line[child.depth++] = Move{static_cast<std::uint8_t>(from),
+                                           static_cast<std::uint8_t>(to)};
+          pending_.fetch_add(1, std::memory_order_relaxed);
+          pushTask(id, child);
+        }
+      }
+    }
+    pending_.fetch_sub(1, std::memory_order_acq_rel);
+  }
+
+  nodes_.fetch_add(nodes, std::memory_order_relaxed);
+  STATS_ADD(Stats::SOLVER_NODES, nodes);
+}
+
+// takes the newest task from this thread's queue, or failing that steals the
+// oldest task from another thread's queue
+// returns false if no task could be found
+bool ParallelSolver::popTask(unsigned id, Task& task) {
+  {
+    std::lock_guard<std::mutex> lock{queues_[id]->mutex};
+    if (!queues_[id]->tasks.empty()) {
+      task = queues_[id]->tasks.back();
+      queues_[id]->tasks.pop_back();
+      return true;
+    }
+  }
+  for (unsigned i = 1; i < threads_; i++) {
+    WorkQueue& victim = *queues_[(id + i) % threads_];
+    std::lock_guard<std::mutex> lock{victim.mutex};
+    if (!victim.tasks.empty()) {
+      task = victim.tasks.front();
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void ParallelSolver::pushTask(unsigned id, const Task& task) {
+  std::lock_guard<std::mutex> lock{queues_[id]->mutex};
+  queues_[id]->tasks.push_back(task);
+}
+
+// searches 'task' depth-first on this thread, extending its line as it goes
+// returns true if the task's board can be solved
+bool ParallelSolver::search(Task& task, std::uint64_t& nodes) {
+  nodes++;
+  const Chessboard board = task.board;
+  const std::uint16_t occ = board.getOccupancy();
+  if ((occ & (occ - 1)) == 0) {
+    return true;
+  }
+  if (found_.load(std::memory_order_relaxed)) {
+    return false;
+  }
+
+  for (std::uint16_t pieces = occ; pieces != 0; pieces &= pieces - 1) {
+    const int from = __builtin_ctz(pieces);
+    const std::uint16_t all_captures = Attacks::captures(board.typeAt(from), from, occ);
+    STATS_ADD(Stats::movesOf(board.typeAt(from)), __builtin_popcount(all_captures));
+    for (std::uint16_t captures = all_captures; captures != 0; captures &= captures - 1) {
+      const int to = __builtin_ctz(captures);
+      task.board = board;
+      task.board.makeMove(from, to);
+      if (isDead(task.board)) {
+        continue;
+      }
+      task.line[task.depth++] = Move{static_cast<std::uint8_t>(from),
+                                     static_cast<std::uint8_t>(to)};
+      if (search(task, nodes)) {
+        return true;
+      }
+      task.depth--;
+    }
+  }
+
+  // a cancelled search proves nothing about this position
+  if (!found_.load(std::memory_order_relaxed)) {
+    markDead(board);
+  }
+  task.board = board;
+  return false;
+}
+
+// records the line of a solved task as the solution, unless another thread
+// got there first, and tells every thread to stop
+void ParallelSolver::publish(const Task& task) {
+  std::lock_guard<std::mutex> lock{solution_mutex_};
+  if (!found_.load()) {
+    solution_.assign(task.line.begin(), task.line.begin() + task.depth);
+    found_.store(true);
+  }
+}
+
+// returns true if 'board' has been proven unsolvable by any thread
+// (probes the slot the Zobrist hash of the position's key points to and the
+// three after it; big pawnless positions are keyed by their canonical form, see
+// TranspositionTable::symmetricKey, so a mirror or turn of one is dead too)
+bool ParallelSolver::isDead(const Chessboard& board) const {
+  const auto [packed, hash] = TranspositionTable::symmetricKey(board, board.pieceCount());
+  const std::uint64_t slot = hash >> dead_shift_;
+  for (std::uint64_t i = 0; i < 4; i++) {
+    const std::uint64_t entry =
+        dead_[(slot + i) & dead_mask_].load(std::memory_order_relaxed);
+    if (entry == packed) {
+      return true;
+    }
+    if (entry == 0) {
+      return false;
+    }
+  }
+  return false;
+}
+
+// records 'board' as unsolvable; claims an empty slot if one of the four
+// probed slots is free, otherwise overwrites the first one
+void ParallelSolver::markDead(const Chessboard& board) {
+  const auto [packed, hash] = TranspositionTable::symmetricKey(board, board.pieceCount());
+  const std::uint64_t slot = hash >> dead_shift_;
+  for (std::uint64_t i = 0; i < 4; i++) {
+    std::atomic<std::uint64_t>& entry = dead_[(slot + i) & dead_mask_];
+    std::uint64_t expected{0};
+    if (entry.compare_exchange_strong(expected, packed, std::memory_order_relaxed) ||
+        expected == packed) {
+      return;
+    }
+  }
+  dead_[slot & dead_mask_].store(packed, std::memory_order_relaxed);
+}
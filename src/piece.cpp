@@ -4,145 +4,104 @@
 #include "../include/piece.hpp"
 #include "../include/piece-type-enum.hpp"
 
+namespace {
+  // the name of each piece type, indexed by PieceType
+  constexpr std::array<std::string_view, 7> kNames{
+      "Empty", "Pawn", "Rook", "Knight", "Bishop", "Queen", "King"};
+
+  // the image of each piece type, indexed by PieceType
+  constexpr std::array<std::array<std::string_view, 7>, 7> kImages{{
+      // EMPTY
+      {"|               ",
+       "|               ",
+       "|               ",
+       "|               ",
+       "|               ",
+       "|               ",
+       "----------------"},
+      // PAWN
+      {"|               ",
+       "|       _       ",
+       "|      (_)      ",
+       "|     _/_\\_     ",
+       "|    (_____)    ",
+       "|               ",
+       "----------------"},
+      // ROOK
+      {"|               ",
+       "|     |UUU|     ",
+       "|      |_|      ",
+       "|     _)_(_     ",
+       "|    (_____)    ",
+       "|               ",
+       "----------------"},
+      // KNIGHT
+      {"|               ",
+       "|    ____|\\     ",
+       "|    L__  |7    ",
+       "|      /  |7    ",
+       "|     (___)     ",
+       "|    (_____)    ",
+       "----------------"},
+      // BISHOP
+      {"|               ",
+       "|       o       ",
+       "|      (/)      ",
+       "|      {_}      ",
+       "|     _)_(_     ",
+       "|    (_____)    ",
+       "----------------"},
+      // QUEEN
+      {"|       o       ",
+       "|     \\^^^/     ",
+       "|     <___>     ",
+       "|      )_(      ",
+       "|     (___)     ",
+       "|    (_____)    ",
+       "----------------"},
+      // KING
+      {"|      _+_      ",
+       "|     \\___/     ",
+       "|      )_(      ",
+       "|     <___>     ",
+       "|     (___)     ",
+       "|    (_____)    ",
+       "----------------"},
+  }};
+}
+
 
 /* MEMBER FUNCTIONS */
 
 // constructor for a chess piece
 Piece::Piece(PieceType::PieceType piece_type, const std::pair<int, int>& position)
-  : piece_type_(piece_type), position_(position), name_(createName(piece_type)),
-    image_(createImage(piece_type)) {}
+  : piece_type_(piece_type), rank_(static_cast<std::int8_t>(position.first)),
+    file_(static_cast<std::int8_t>(position.second)) {
+  if (piece_type < PieceType::EMPTY || piece_type > PieceType::KING) {
+    std::cout << "error: tried to create non-chess-piece.\n";
+    piece_type_ = PieceType::EMPTY;
+  }
+}
 
 // returns the PieceType type of a chess piece
-const PieceType::PieceType& Piece::getPieceType() const {
-  return piece_type_;
+PieceType::PieceType Piece::getPieceType() const {
+  return static_cast<PieceType::PieceType>(piece_type_);
 }
 
-const std::string& Piece::getName() const {
-  return name_;
+std::string_view Piece::getName() const {
+  return kNames[piece_type_];
 }
 
 void Piece::setPosition(const std::pair<int, int>& position) {
-  position_ = position;
+  rank_ = static_cast<std::int8_t>(position.first);
+  file_ = static_cast<std::int8_t>(position.second);
 }
 
-const std::pair<int, int>& Piece::getPosition() const {
-  return position_;
+std::pair<int, int> Piece::getPosition() const {
+  return {rank_, file_};
 }
 
 // returns the image of the chess piece
-const std::array<std::string, 7>& Piece::getImage() const {
-  return image_;
-}
-
-
-
-/* HELPER or NON-MEMBER FUNCTIONS */
-
-namespace {
-
-  // sets a name for chess piece given its piece type; used in Piece constructor
-  std::string createName(PieceType::PieceType piece_type)
-  {
-    using namespace PieceType;
-    if (piece_type == EMPTY)
-    {
-      return "Empty";
-    }
-    else if (piece_type == PAWN)
-    {
-      return "Pawn";
-    }
-    else if (piece_type == ROOK)
-    {
-      return "Rook";
-    }
-    else if (piece_type == KNIGHT)
-    {
-      return "Knight";
-    }
-    else if (piece_type == BISHOP)
-    {
-      return "Bishop";
-    }
-    else if (piece_type == QUEEN)
-    {
-      return "Queen";
-    }
-    else if (piece_type == KING)
-    {
-      return "King";
-    }
-    else
-    {
-      std::cout << "error: tried to create name for non-chess-piece\n";
-      return "ERROR";
-    }
-  }
-
-  // creates the image of a chess piece given the piece type
-  std::array<std::string, 7> createImage(PieceType::PieceType piece_type) {
-    using namespace PieceType;
-
-    if (piece_type == EMPTY) {
-      return {"|               ",
-              "|               ",
-              "|               ",
-              "|               ",
-              "|               ",
-              "|               ",
-              "----------------"};
-    } if (piece_type == PAWN) {
-      return {"|               ",
-              "|       _       ",
-              "|      (_)      ",
-              "|     _/_\\_     ",
-              "|    (_____)    ",
-              "|               ",
-              "----------------"};
-    } else if (piece_type == ROOK) {
-      return {"|               ",
-              "|     |UUU|     ",
-              "|      |_|      ",
-              "|     _)_(_     ",
-              "|    (_____)    ",
-              "|               ",
-              "----------------"};
-    } else if (piece_type == KNIGHT) {
-      return {"|               ",
-              "|    ____|\\     ",
-              "|    L__  |7    ",
-              "|      /  |7    ",
-              "|     (___)     ",
-              "|    (_____)    ",
-              "----------------"};
-    } else if (piece_type == BISHOP) {
-      return {"|               ",
-              "|       o       ",
-              "|      (/)      ",
-              "|      {_}      ",
-              "|     _)_(_     ",
-              "|    (_____)    ",
-              "----------------"};
-    } else if (piece_type == QUEEN) {
-      return {"|       o       ",
-              "|     \\^^^/     ",
-              "|     <___>     ",
-              "|      )_(      ",
-              "|     (___)     ",
-              "|    (_____)    ",
-              "----------------"};
-    } else if (piece_type == KING) {
-      return {"|      _+_      ",
-              "|     \\___/     ",
-              "|      )_(      ",
-              "|     <___>     ",
-              "|     (___)     ",
-              "|    (_____)    ",
-              "----------------"};
-    } else {
-      std::cout << "error: tried to set image of non-chess-piece.\n";
-      return {"E", "R", "R", "O", "R", "!", "!"};
-    }
-  }
-
+const std::array<std::string_view, 7>& Piece::getImage() const {
+  return kImages[piece_type_];
 }
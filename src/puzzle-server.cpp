@@ -0,0 +1,381 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../include/chessboard.hpp"
+#include "../include/hint-engine.hpp"
+#include "../include/notation.hpp"
+#include "../include/puzzle-server.hpp"
+#include "../include/replay.hpp"
+#include "../include/solver.hpp"
+
+namespace {
+  // the longest request line read; a client sending a longer one is dropped
+  constexpr std::size_t kMaxRequest{4096};
+  // bytes read from a connection at once, and reads per turn, after which
+  // the connection goes to the back of the line so one client can't hog a
+  // thread
+  constexpr std::size_t kReadSize{1 << 16};
+  constexpr int kReadsPerTurn{4};
+  // the longest a SOLVE request searches before it's answered TIMEOUT, so a
+  // hard board holds a thread no longer than a hint does
+  constexpr std::chrono::microseconds kSolveBudget{std::chrono::milliseconds(1)};
+}
+
+struct PuzzleServer::Connection {
+  int fd;
+  std::string pending;
+  // replies the client hasn't taken yet
+  std::string unsent;
+  // set once the client has stopped sending (or broken the protocol); the
+  // connection closes when 'unsent' is empty
+  bool closing{false};
+};
+
+struct PuzzleServer::Worker {
+  Solver solver;
+  HintEngine hints;
+  std::vector<char> buffer = std::vector<char>(kReadSize);
+};
+
+
+/* MEMBER FUNCTIONS */
+
+// constructor for the server; 'threads' of 0 means one per hardware thread
+PuzzleServer::PuzzleServer(const LevelPack& level_pack, const Tablebase& tablebase,
+                           unsigned threads)
+    : level_pack_(level_pack),
+      tablebase_(tablebase),
+      threads_(threads != 0 ? threads
+                            : std::max(1u, std::thread::hardware_concurrency())) {}
+
+PuzzleServer::~PuzzleServer() {
+  for (auto& [fd, connection] : connections_) {
+    ::close(fd);
+  }
+  for (int fd : {listen_fd_, epoll_fd_, stop_fd_}) {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+  }
+  if (listen_fd_ >= 0) {
+    unlink(path_.c_str());
+  }
+}
+
+// starts listening on the socket file at 'path' (replacing a stale one);
+// returns false if that isn't possible
+bool PuzzleServer::listen(const std::string& path) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+    std::cerr << "error: socket path must be 1-" << sizeof(address.sun_path) - 1
+              << " characters long.\n";
+    return false;
+  }
+  std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+  listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  stop_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (listen_fd_ < 0 || epoll_fd_ < 0 || stop_fd_ < 0) {
+    std::cerr << "error: couldn't set up the server: " << std::strerror(errno) << ".\n";
+    return false;
+  }
+  unlink(path.c_str());
+  if (bind(listen_fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+      ::listen(listen_fd_, SOMAXCONN) != 0) {
+    std::cerr << "error: couldn't listen on " << path << ": " << std::strerror(errno)
+              << ".\n";
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    return false;
+  }
+  path_ = path;
+
+  // the listening socket is handed to one thread at a time, like a
+  // connection; the stop signal wakes every thread and stays set
+  epoll_event listen_event{EPOLLIN | EPOLLONESHOT, {}};
+  listen_event.data.ptr = &listen_fd_;
+  epoll_event stop_event{EPOLLIN, {}};
+  stop_event.data.ptr = &stop_fd_;
+  return epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &listen_event) == 0 &&
+         epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, stop_fd_, &stop_event) == 0;
+}
+
+// serves connections until stop() is called
+void PuzzleServer::run() {
+  std::vector<std::thread> threads;
+  for (unsigned i = 1; i < threads_; i++) {
+    threads.emplace_back(&PuzzleServer::serve, this);
+  }
+  serve();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+// makes run() return once every thread has finished the request it's on
+void PuzzleServer::stop() {
+  const std::uint64_t one{1};
+  static_cast<void>(write(stop_fd_, &one, sizeof(one)));
+}
+
+// waits for and serves connections until stopped
+void PuzzleServer::serve() {
+  Worker worker;
+  worker.solver.setTablebase(&tablebase_);
+  worker.hints.setTablebase(&tablebase_);
+
+  while (true) {
+    epoll_event event;
+    if (const int ready = epoll_wait(epoll_fd_, &event, 1, -1); ready != 1) {
+      if (ready < 0 && errno != EINTR) {
+        std::cerr << "error: waiting for connections failed: " << std::strerror(errno)
+                  << ".\n";
+        return;
+      }
+      continue;  // interrupted by a signal
+    }
+    if (event.data.ptr == &stop_fd_) {
+      return;
+    }
+    if (event.data.ptr == &listen_fd_) {
+      acceptAll();
+      event.events = EPOLLIN | EPOLLONESHOT;
+      epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, listen_fd_, &event);
+      continue;
+    }
+
+    Connection& connection = *static_cast<Connection*>(event.data.ptr);
+    if (const std::uint32_t events = serveConnection(connection, worker); events != 0) {
+      event.events = events;
+      epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, connection.fd, &event);
+    } else {
+      // the entry goes before the descriptor is closed: from then on accept4
+      // can hand the same number to a new connection
+      const int fd = connection.fd;
+      epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+      const std::lock_guard<std::mutex> lock{connections_mutex_};
+      connections_.erase(fd);
+      ::close(fd);
+    }
+  }
+}
+
+// accepts every pending connection
+void PuzzleServer::acceptAll() {
+  for (int fd; (fd = accept4(listen_fd_, nullptr, nullptr,
+                             SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0;) {
+    epoll_event event{EPOLLIN | EPOLLRDHUP | EPOLLONESHOT, {}};
+    {
+      const std::lock_guard<std::mutex> lock{connections_mutex_};
+      const auto [entry, added] =
+          connections_.emplace(fd, std::make_unique<Connection>(Connection{fd, {}}));
+      if (!added) {
+        // only the map owns connections, so one it couldn't take isn't served
+        ::close(fd);
+        continue;
+      }
+      event.data.ptr = entry->second.get();
+    }
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+  }
+}
+
+// reads what 'connection' has sent and answers every complete request;
+// returns the events to wait for on it next, or 0 once it should be closed
+// a client that doesn't take its replies isn't read from (or waited for)
+// until it has taken them all, so it can only hold up itself
+std::uint32_t PuzzleServer::serveConnection(Connection& connection, Worker& worker) {
+  if (!connection.unsent.empty()) {
+    if (!flush(connection)) {
+      return 0;
+    }
+    if (!connection.unsent.empty()) {
+      return EPOLLOUT | EPOLLONESHOT;
+    }
+  }
+  if (connection.closing) {
+    return 0;
+  }
+
+  for (int reads = 0; reads < kReadsPerTurn; reads++) {
+    const ssize_t count = read(connection.fd, worker.buffer.data(), worker.buffer.size());
+    if (count <= 0) {
+      connection.closing =
+          !(count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR));
+      break;
+    }
+    connection.pending.append(worker.buffer.data(), static_cast<std::size_t>(count));
+
+    // answers every whole line, keeping a partial last one for next time
+    std::size_t start{0};
+    for (std::size_t end; (end = connection.pending.find('\n', start)) != std::string::npos;
+         start = end + 1) {
+      answer(std::string_view{connection.pending}.substr(start, end - start), worker,
+             connection.unsent);
+    }
+    connection.pending.erase(0, start);
+    if (connection.pending.size() > kMaxRequest) {
+      connection.unsent += "ERROR request too long\n";
+      connection.closing = true;
+      break;
+    }
+    if (static_cast<std::size_t>(count) < worker.buffer.size()) {
+      break;
+    }
+  }
+
+  if (!flush(connection)) {
+    return 0;
+  }
+  if (!connection.unsent.empty()) {
+    return EPOLLOUT | EPOLLONESHOT;
+  }
+  return connection.closing ? 0 : EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+}
+
+// sends as much of 'connection's unsent replies as the socket takes without
+// waiting; returns false if the client has gone
+bool PuzzleServer::flush(Connection& connection) {
+  std::size_t sent{0};
+  while (sent < connection.unsent.size()) {
+    const ssize_t count = send(connection.fd, connection.unsent.data() + sent,
+                               connection.unsent.size() - sent, MSG_NOSIGNAL);
+    if (count > 0) {
+      sent += static_cast<std::size_t>(count);
+    } else if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      break;
+    } else if (count == 0 || errno != EINTR) {
+      return false;
+    }
+  }
+  connection.unsent.erase(0, sent);
+  return true;
+}
+
+// appends the answer to one request line to 'out'
+void PuzzleServer::answer(std::string_view request, Worker& worker, std::string& out) const {
+  while (!request.empty() && (request.back() == '\r' || request.back() == ' ')) {
+    request.remove_suffix(1);
+  }
+  if (request.empty()) {
+    return;
+  }
+  const std::size_t space = std::min(request.find(' '), request.size());
+  const std::string_view command = request.substr(0, space);
+  std::string_view argument = request.substr(space);
+  while (!argument.empty() && argument.front() == ' ') {
+    argument.remove_prefix(1);
+  }
+
+  if (command == "VALIDATE") {
+    Replay::appendResult(Replay::validateLine(argument, level_pack_), out);
+    return;
+  }
+  if (command == "LEVEL") {
+    Chessboard board = Chessboard::fromPacked(0);
+    if (argument.empty() || argument.find_first_not_of("0123456789") != std::string_view::npos ||
+        !parseBoard(argument, board)) {
+      out += "ERROR no such level\n";
+      return;
+    }
+    out += "LEVEL ";
+    out += argument;
+    out += ' ';
+    Notation::append(board.getPacked(), out);
+    out += '\n';
+    return;
+  }
+  if (command != "SOLVE" && command != "HINT") {
+    out += "ERROR unknown request\n";
+    return;
+  }
+
+  Chessboard board = Chessboard::fromPacked(0);
+  if (!parseBoard(argument, board)) {
+    out += "ERROR not a level or a position\n";
+    return;
+  }
+  if (command == "SOLVE") {
+    worker.solver.setDeadline(std::chrono::steady_clock::now() + kSolveBudget);
+    const std::optional<std::vector<Move>> solution = worker.solver.solve(board);
+    worker.solver.clearDeadline();
+    if (!solution) {
+      out += worker.solver.wasAborted() ? "TIMEOUT\n" : "UNSOLVABLE\n";
+      return;
+    }
+    out += "SOLVED";
+    for (const Move& move : *solution) {
+      out += ' ';
+      appendMove(move, out);
+    }
+    out += '\n';
+    return;
+  }
+
+  const HintEngine::Hint hint = worker.hints.hint(board);
+  switch (hint.status) {
+    case HintEngine::Status::WINNING:
+      out += "HINT ";
+      appendMove(hint.move, out);
+      out += '\n';
+      break;
+    case HintEngine::Status::SOLVED: out += "SOLVED\n"; break;
+    case HintEngine::Status::UNSOLVABLE: out += "UNSOLVABLE\n"; break;
+    case HintEngine::Status::TIMEOUT: out += "TIMEOUT\n"; break;
+  }
+}
+
+// reads a level number or a position into 'board'; returns false if 'text'
+// is neither
+bool PuzzleServer::parseBoard(std::string_view text, Chessboard& board) const {
+  if (!text.empty() && text.size() <= 9 &&
+      text.find_first_not_of("0123456789") == std::string_view::npos) {
+    std::uint32_t level{0};
+    for (char digit : text) {
+      level = level * 10 + static_cast<std::uint32_t>(digit - '0');
+    }
+    const std::uint64_t* record = level_pack_.find(level);
+    if (record == nullptr) {
+      return false;
+    }
+    board = Chessboard::fromPacked(*record);
+    return true;
+  }
+  std::uint64_t packed;
+  if (!Notation::parse(text, packed)) {
+    return false;
+  }
+  board = Chessboard::fromPacked(packed);
+  return true;
+}
+
+
+
+/* HELPER or NON-MEMBER FUNCTIONS */
+
+namespace {
+
+  // appends 'move' to 'out' in "1A-2B" format (as moveToDisplay writes it,
+  // without building a string); square 0 is 4A
+  void appendMove(const Move& move, std::string& out) {
+    const char text[5]{static_cast<char>('4' - move.from / 4),
+                       static_cast<char>('A' + move.from % 4), '-',
+                       static_cast<char>('4' - move.to / 4),
+                       static_cast<char>('A' + move.to % 4)};
+    out.append(text, sizeof(text));
+  }
+}
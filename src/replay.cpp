@@ -0,0 +1,133 @@
+#include "../include/coord-conversions.hpp"
+#include "../include/replay.hpp"
+
+namespace {
+  // skips spaces and tabs (and a stray '\r' from Windows line endings)
+  std::size_t skipBlanks(std::string_view text, std::size_t at) {
+    while (at < text.size() && (text[at] == ' ' || text[at] == '\t' || text[at] == '\r')) {
+      at++;
+    }
+    return at;
+  }
+
+  // returns the end of the token starting at 'at'
+  std::size_t tokenEnd(std::string_view text, std::size_t at) {
+    while (at < text.size() && text[at] != ' ' && text[at] != '\t' && text[at] != '\r') {
+      at++;
+    }
+    return at;
+  }
+
+  void appendNumber(int number, std::string& out) {
+    char digits[12];
+    int count{0};
+    do {
+      digits[count++] = static_cast<char>('0' + number % 10);
+      number /= 10;
+    } while (number > 0);
+    while (count > 0) {
+      out += digits[--count];
+    }
+  }
+}
+
+namespace Replay {
+  // returns the square index (0-15) written as e.g. "2B", or -1
+  int parseSquare(std::string_view text) {
+    if (text.size() != 2 || text[0] < '1' || text[0] > '4') {
+      return -1;
+    }
+    // folds lowercase onto uppercase
+    const char file = static_cast<char>(text[1] & ~0x20);
+    if (file < 'A' || file > 'D') {
+      return -1;
+    }
+    return Coords::coordToIndex({text[0] - '0', file - 'A' + 1});
+  }
+
+  // reads a move written as e.g. "2B-4C" into 'move'; returns false if 'text'
+  // isn't one
+  bool parseMove(std::string_view text, Move& move) {
+    if (text.size() != 5 || text[2] != '-') {
+      return false;
+    }
+    const int from = parseSquare(text.substr(0, 2));
+    const int to = parseSquare(text.substr(3, 2));
+    if (from < 0 || to < 0) {
+      return false;
+    }
+    move = Move{static_cast<std::uint8_t>(from), static_cast<std::uint8_t>(to)};
+    return true;
+  }
+
+  // plays the space-separated 'moves' from 'start'
+  Result validate(const Chessboard& start, std::string_view moves) {
+    Chessboard board = start;
+    Result result{Status::INCOMPLETE, -1, 0, board.pieceCount(), {}};
+    for (std::size_t at = skipBlanks(moves, 0); at < moves.size();
+         at = skipBlanks(moves, at)) {
+      const std::size_t end = tokenEnd(moves, at);
+      const std::string_view token = moves.substr(at, end - at);
+      Move move;
+      // a legal move starts on a piece and captures one of its targets
+      if (!parseMove(token, move) || board.typeAt(move.from) == PieceType::EMPTY ||
+          ((board.getCaptures(move.from) >> move.to) & 1) == 0) {
+        result.status = Status::ILLEGAL;
+        result.bad_move = token;
+        return result;
+      }
+      board.makeMove(move.from, move.to);
+      result.moves_played++;
+      result.pieces_left--;
+      at = end;
+    }
+    result.status = result.pieces_left == 1 ? Status::SOLVED : Status::INCOMPLETE;
+    return result;
+  }
+
+  // checks one game line, "<level> <move> ...", with the level taken from
+  // 'pack'
+  Result validateLine(std::string_view line, const LevelPack& pack) {
+    const Result invalid{Status::INVALID, -1, 0, 0, {}};
+    std::size_t at = skipBlanks(line, 0);
+    int level{0};
+    const std::size_t digits_start = at;
+    while (at < line.size() && line[at] >= '0' && line[at] <= '9' && at - digits_start < 9) {
+      level = level * 10 + (line[at] - '0');
+      at++;
+    }
+    if (at == digits_start ||
+        (at < line.size() && line[at] != ' ' && line[at] != '\t' && line[at] != '\r')) {
+      return invalid;
+    }
+    const std::uint64_t* record = pack.find(static_cast<std::uint32_t>(level));
+    if (record == nullptr) {
+      return invalid;
+    }
+    Result result = validate(Chessboard::fromPacked(*record), line.substr(at));
+    result.level = level;
+    return result;
+  }
+
+  // appends a one-line description of 'result' (with a trailing newline)
+  void appendResult(const Result& result, std::string& out) {
+    if (result.status == Status::INVALID) {
+      out += "- INVALID\n";
+      return;
+    }
+    appendNumber(result.level, out);
+    if (result.status == Status::SOLVED) {
+      out += " SOLVED ";
+      appendNumber(result.moves_played, out);
+    } else if (result.status == Status::INCOMPLETE) {
+      out += " INCOMPLETE ";
+      appendNumber(result.pieces_left, out);
+    } else {
+      out += " ILLEGAL ";
+      appendNumber(result.moves_played + 1, out);
+      out += ' ';
+      out += result.bad_move;
+    }
+    out += '\n';
+  }
+}
@@ -0,0 +1,94 @@
+#include <algorithm>
+
+#include "../include/attack-tables.hpp"
+#include "../include/chessboard.hpp"
+#include "../include/solution-counter.hpp"
+#include "../include/stats.hpp"
+#include "../include/tablebase.hpp"
+#include "../include/transposition-table.hpp"
+
+
+/* MEMBER FUNCTIONS */
+
+// constructor for the solution counter
+SolutionCounter::SolutionCounter(std::size_t kilobytes) : table_(kilobytes) {}
+
+// returns the number of capture sequences that solve 'board'
+std::uint64_t SolutionCounter::count(const Chessboard& board) {
+  return countUpTo(board, kMaxCount);
+}
+
+// returns the number of capture sequences that solve 'board', or 'limit' if
+// there are at least that many
+std::uint64_t SolutionCounter::countUpTo(const Chessboard& board, std::uint64_t limit) {
+  limit = std::min(limit, kMaxCount);
+  if (board.pieceCount() == 0 || limit == 0) {
+    return 0;
+  }
+  return search(board, limit);
+}
+
+// returns true if exactly one sequence of captures solves 'board'
+bool SolutionCounter::isUnique(const Chessboard& board) {
+  return countUpTo(board, 2) == 1;
+}
+
+// skips boards small enough for 'tablebase' that it knows are unsolvable
+void SolutionCounter::setTablebase(const Tablebase* tablebase) {
+  tablebase_ = (tablebase != nullptr && tablebase->isOpen()) ? tablebase : nullptr;
+}
+
+std::uint64_t SolutionCounter::getNodes() const {
+  return nodes_;
+}
+
+// returns the number of solutions of 'board', or 'limit' if there are at least
+// that many
+std::uint64_t SolutionCounter::search(const Chessboard& board, std::uint64_t limit) {
+  nodes_++;
+  STATS_ADD(Stats::SOLVER_NODES, 1);
+  const std::uint16_t occ = board.getOccupancy();
+  // exactly one piece left: the empty sequence solves it
+  if ((occ & (occ - 1)) == 0) {
+    return 1;
+  }
+  // a board the tablebase knows is lost has no solutions to count (a won one
+  // still has to be walked, since the tablebase only keeps one capture)
+  if (tablebase_ != nullptr && __builtin_popcount(occ) <= tablebase_->getMaxPieces() &&
+      !tablebase_->probe(board).solvable) {
+    return 0;
+  }
+
+  // a board and its symmetric images have the same number of solutions
+  const std::uint8_t depth = static_cast<std::uint8_t>(__builtin_popcount(occ));
+  const TranspositionTable::Key key = TranspositionTable::symmetricKey(board, depth);
+  if (const TranspositionTable::Entry* entry = table_.probe(key.packed, key.hash)) {
+    if (!(entry->flags & TranspositionTable::LOWER_BOUND) || entry->value >= limit) {
+      return std::min<std::uint64_t>(entry->value, limit);
+    }
+  }
+
+  std::uint64_t count{0};
+  for (std::uint16_t pieces = occ; pieces != 0; pieces &= pieces - 1) {
+    const int from = __builtin_ctz(pieces);
+    const std::uint16_t all_captures = Attacks::captures(board.typeAt(from), from, occ);
+    STATS_ADD(Stats::movesOf(board.typeAt(from)), __builtin_popcount(all_captures));
+    for (std::uint16_t captures = all_captures; captures != 0; captures &= captures - 1) {
+      Chessboard next = board;
+      next.makeMove(from, __builtin_ctz(captures));
+      // each capture only needs to find what's still missing from the limit
+      count += search(next, limit - count);
+      if (count >= limit) {
+        table_.store(key.packed, key.hash,
+                     {0, static_cast<std::uint32_t>(limit), Move{}, depth,
+                      TranspositionTable::SOLVABLE | TranspositionTable::LOWER_BOUND});
+        return limit;
+      }
+    }
+  }
+
+  table_.store(key.packed, key.hash,
+               {0, static_cast<std::uint32_t>(count), Move{}, depth,
+                count != 0 ? TranspositionTable::SOLVABLE : TranspositionTable::UNSOLVABLE});
+  return count;
+}
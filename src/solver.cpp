@@ -0,0 +1,162 @@
+#include "../include/attack-tables.hpp"
+#include "../include/chessboard.hpp"
+#include "../include/move.hpp"
+#include "../include/solver.hpp"
+#include "../include/stats.hpp"
+#include "../include/symmetry.hpp"
+#include "../include/tablebase.hpp"
+#include "../include/transposition-table.hpp"
+
+
+/* MEMBER FUNCTIONS */
+
+// constructor for the solver
+Solver::Solver(TranspositionTable* table)
+    : own_table_(table == nullptr ? std::make_unique<TranspositionTable>() : nullptr),
+      table_(table == nullptr ? own_table_.get() : table) {}
+
+// returns the captures that solve 'board', in order, or std::nullopt if the
+// board can't be solved
+std::optional<std::vector<Move>> Solver::solve(const Chessboard& board) {
+  STATS_PHASE(Stats::SOLVE);
+  std::vector<Move> line;
+  line.reserve(16);
+  aborted_ = false;
+  if (board.pieceCount() == 0 || !search(board, line)) {
+    return std::nullopt;
+  }
+  return line;
+}
+
+// returns true if 'board' can be solved, without handing back the line
+bool Solver::isSolvable(const Chessboard& board) {
+  scratch_line_.clear();
+  aborted_ = false;
+  return board.pieceCount() != 0 && search(board, scratch_line_);
+}
+
+// answers boards small enough for 'tablebase' straight from it
+void Solver::setTablebase(const Tablebase* tablebase) {
+  tablebase_ = (tablebase != nullptr && tablebase->isOpen()) ? tablebase : nullptr;
+}
+
+// makes every search give up once 'deadline' has passed
+void Solver::setDeadline(std::chrono::steady_clock::time_point deadline) {
+  deadline_ = deadline;
+  has_deadline_ = true;
+}
+
+void Solver::clearDeadline() {
+  has_deadline_ = false;
+}
+
+// returns true if the last search gave up at the deadline
+bool Solver::wasAborted() const {
+  return aborted_;
+}
+
+std::uint64_t Solver::getNodes() const {
+  return nodes_;
+}
+
+// returns true if 'board' can be solved, appending the captures that solve it
+// to 'line'
+bool Solver::search(const Chessboard& board, std::vector<Move>& line) {
+  nodes_++;
+  STATS_ADD(Stats::SOLVER_NODES, 1);
+  if (has_deadline_ && (nodes_ & 0xFF) == 0 &&
+      std::chrono::steady_clock::now() >= deadline_) {
+    aborted_ = true;
+  }
+  // an abandoned search proves nothing, so nothing is stored on the way out
+  if (aborted_) {
+    return false;
+  }
+  const std::uint16_t occ = board.getOccupancy();
+  // exactly one piece left
+  if ((occ & (occ - 1)) == 0) {
+    return true;
+  }
+
+  // small boards are looked up rather than searched, following the
+  // tablebase's winning captures down to the last piece; a capture the board
+  // doesn't have (only a damaged file names one) drops back to searching
+  if (tablebase_ != nullptr && __builtin_popcount(occ) <= tablebase_->getMaxPieces()) {
+    const Tablebase::Probe probe = tablebase_->probe(board);
+    if (!probe.solvable) {
+      return false;
+    }
+    const std::size_t line_start = line.size();
+    Chessboard next = board;
+    int captures_left = probe.captures_left;
+    for (; captures_left > 0; captures_left--) {
+      const Move move = tablebase_->probe(next).move;
+      if (((next.getCaptures(move.from) >> move.to) & 1) == 0) {
+        break;
+      }
+      line.push_back(move);
+      next.makeMove(move.from, move.to);
+    }
+    if (captures_left == 0) {
+      return true;
+    }
+    line.resize(line_start);
+  }
+
+  // big pawnless positions are looked up and stored in canonical form (see
+  // TranspositionTable::symmetricKey), so every turn or mirror of one
+  // searched before is a hit too; moves are stored as played on the key's
+  // board
+  const std::uint8_t depth = static_cast<std::uint8_t>(__builtin_popcount(occ));
+  const TranspositionTable::Key key = TranspositionTable::symmetricKey(board, depth);
+
+  // a position searched before either is a known dead end or comes with the
+  // capture that solved it last time
+  if (const TranspositionTable::Entry* entry = table_->probe(key.packed, key.hash)) {
+    if (entry->flags & TranspositionTable::UNSOLVABLE) {
+      return false;
+    }
+    const Move move =
+        key.packed == board.getPacked()
+            ? entry->move
+            : Symmetry::mapMove(
+                  Symmetry::inverse(Symmetry::transformTo(board.getPacked(), key.packed)),
+                  entry->move);
+    Chessboard next = board;
+    next.makeMove(move.from, move.to);
+    line.push_back(move);
+    if (search(next, line)) {
+      return true;
+    }
+    line.pop_back();
+  }
+
+  // tries every capture of every piece
+  for (std::uint16_t pieces = occ; pieces != 0; pieces &= pieces - 1) {
+    const int from = __builtin_ctz(pieces);
+    const std::uint16_t all_captures = Attacks::captures(board.typeAt(from), from, occ);
+    STATS_ADD(Stats::movesOf(board.typeAt(from)), __builtin_popcount(all_captures));
+    for (std::uint16_t captures = all_captures; captures != 0; captures &= captures - 1) {
+      const int to = __builtin_ctz(captures);
+      const Move move{static_cast<std::uint8_t>(from), static_cast<std::uint8_t>(to)};
+      Chessboard next = board;
+      next.makeMove(from, to);
+      line.push_back(move);
+      if (search(next, line)) {
+        const Move stored =
+            key.packed == board.getPacked()
+                ? move
+                : Symmetry::mapMove(Symmetry::transformTo(board.getPacked(), key.packed), move);
+        table_->store(key.packed, key.hash, {0, 0, stored, depth, TranspositionTable::SOLVABLE});
+        return true;
+      }
+      line.pop_back();
+      if (aborted_) {
+        return false;
+      }
+    }
+  }
+
+  table_->store(key.packed, key.hash, {0, 0, Move{}, depth, TranspositionTable::UNSOLVABLE});
+  return false;
+}
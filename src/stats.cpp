@@ -0,0 +1,111 @@
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../include/stats.hpp"
+
+namespace {
+  constexpr const char* kCounterNames[Stats::kCounterCount]{
+      "getMoves calls", "moves (pawn)", "moves (rook)", "moves (knight)",
+      "moves (bishop)", "moves (queen)", "moves (king)", "updateBoard calls",
+      "board copies", "solver nodes", "table hits", "table misses"};
+  constexpr const char* kPhaseNames[Stats::kPhaseCount]{
+      "solve", "generate", "build tablebase", "batch", "hint"};
+
+  // every thread's block; blocks are never freed, so the counts of worker
+  // threads that have already finished still make it into the report
+  std::mutex registry_mutex;
+  std::vector<std::unique_ptr<Stats::Block>> registry;
+}
+
+
+/* MEMBER FUNCTIONS */
+
+Stats::ScopedPhase::ScopedPhase(Phase phase)
+    : phase_(phase), start_(std::chrono::steady_clock::now()) {}
+
+Stats::ScopedPhase::~ScopedPhase() {
+  std::atomic<std::uint64_t>& time = localBlock().phase_nanoseconds[phase_];
+  const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start_);
+  time.store(time.load(std::memory_order_relaxed) + elapsed.count(),
+             std::memory_order_relaxed);
+}
+
+
+
+/* HELPER or NON-MEMBER FUNCTIONS */
+
+// returns this thread's block, registering it on first use
+Stats::Block& Stats::localBlock() {
+  thread_local Block& block = []() -> Block& {
+    std::lock_guard<std::mutex> lock{registry_mutex};
+    registry.push_back(std::make_unique<Block>());
+    return *registry.back();
+  }();
+  return block;
+}
+
+// returns every thread's counts summed together
+Stats::Snapshot Stats::snapshot() {
+  Snapshot sum;
+  std::lock_guard<std::mutex> lock{registry_mutex};
+  for (const std::unique_ptr<Block>& block : registry) {
+    for (int i = 0; i < kCounterCount; i++) {
+      sum.counts[i] += block->counts[i].load(std::memory_order_relaxed);
+    }
+    for (int i = 0; i < kPhaseCount; i++) {
+      sum.phase_nanoseconds[i] += block->phase_nanoseconds[i].load(std::memory_order_relaxed);
+    }
+  }
+  return sum;
+}
+
+// writes 'snapshot' as an aligned table
+void Stats::writeTable(const Snapshot& snapshot, std::ostream& out) {
+  if (!kEnabled) {
+    out << "stats: nothing counted; build with -DSOLITAIRE_CHESS_STATS=ON\n";
+    return;
+  }
+  for (int i = 0; i < kCounterCount; i++) {
+    out << std::left << std::setw(22) << kCounterNames[i] << std::right
+        << std::setw(16) << snapshot.counts[i] << "\n";
+  }
+  for (int i = 0; i < kPhaseCount; i++) {
+    out << std::left << std::setw(22) << (std::string{kPhaseNames[i]} + " time")
+        << std::right << std::fixed << std::setprecision(3) << std::setw(13)
+        << snapshot.phase_nanoseconds[i] / 1e6 << " ms\n";
+  }
+}
+
+// writes 'snapshot' as JSON
+void Stats::writeJson(const Snapshot& snapshot, std::ostream& out) {
+  out << "{\n  \"enabled\": " << (kEnabled ? "true" : "false") << ",\n  \"counters\": {";
+  for (int i = 0; i < kCounterCount; i++) {
+    out << (i == 0 ? "\n" : ",\n") << "    \"" << jsonKey(kCounterNames[i])
+        << "\": " << snapshot.counts[i];
+  }
+  out << "\n  },\n  \"phase_ns\": {";
+  for (int i = 0; i < kPhaseCount; i++) {
+    out << (i == 0 ? "\n" : ",\n") << "    \"" << jsonKey(kPhaseNames[i])
+        << "\": " << snapshot.phase_nanoseconds[i];
+  }
+  out << "\n  }\n}\n";
+}
+
+namespace {
+
+  // returns 'name' with spaces turned into underscores and brackets dropped
+  std::string jsonKey(const char* name) {
+    std::string key;
+    for (const char* c = name; *c != '\0'; c++) {
+      if (*c == ' ') {
+        key += '_';
+      } else if (*c != '(' && *c != ')') {
+        key += *c;
+      }
+    }
+    return key;
+  }
+}
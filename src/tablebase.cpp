@@ -0,0 +1,263 @@
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../include/attack-tables.hpp"
+#include "../include/chessboard.hpp"
+#include "../include/stats.hpp"
+#include "../include/symmetry.hpp"
+#include "../include/tablebase.hpp"
+
+namespace {
+  // entry values that aren't captures (a capture never has from == to)
+  constexpr std::uint8_t kUnsolvable{0x00};
+  constexpr std::uint8_t kSolved{0xFF};
+
+  // kChoose[n][k] is n choose k
+  constexpr std::array<std::array<std::uint64_t, 17>, 17> makeChoose() {
+    std::array<std::array<std::uint64_t, 17>, 17> choose{};
+    for (int n = 0; n <= 16; n++) {
+      choose[n][0] = 1;
+      for (int k = 1; k <= n; k++) {
+        choose[n][k] = choose[n - 1][k - 1] + (k <= n - 1 ? choose[n - 1][k] : 0);
+      }
+    }
+    return choose;
+  }
+  constexpr std::array<std::array<std::uint64_t, 17>, 17> kChoose{makeChoose()};
+
+  // kPowersOfSix[k] is 6^k
+  constexpr std::array<std::uint64_t, 17> makePowersOfSix() {
+    std::array<std::uint64_t, 17> powers{};
+    powers[0] = 1;
+    for (int k = 1; k <= 16; k++) {
+      powers[k] = powers[k - 1] * 6;
+    }
+    return powers;
+  }
+  constexpr std::array<std::uint64_t, 17> kPowersOfSix{makePowersOfSix()};
+}
+
+
+/* MEMBER FUNCTIONS */
+
+Tablebase::~Tablebase() {
+  close();
+}
+
+// computes the tablebase for boards of up to 'max_pieces' pieces and writes it
+// to 'path'; returns false if the file couldn't be written
+bool Tablebase::build(int max_pieces, const std::string& path) {
+  STATS_PHASE(Stats::BUILD_TABLEBASE);
+  if (max_pieces < 1 || max_pieces > 16) {
+    std::cerr << "error: tablebase piece count must be within range 1-16.\n";
+    return false;
+  }
+
+  Header header{{'S', 'C', 'T', 'B'}, 2, static_cast<std::uint32_t>(max_pieces), 0, {}};
+  std::uint64_t offset = sizeof(Header);
+  for (int pieces = 1; pieces <= max_pieces; pieces++) {
+    header.layer_offsets[pieces] = offset;
+    offset += layerSize(pieces);
+  }
+
+  std::ofstream file{path, std::ios::binary};
+  if (!file) {
+    std::cerr << "error: couldn't write tablebase to " << path << ".\n";
+    return false;
+  }
+  file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+  // layers are solved from one piece upward; each capture lands in the layer
+  // below, which is already complete
+  std::vector<std::uint8_t> below;
+  for (int pieces = 1; pieces <= max_pieces; pieces++) {
+    std::vector<std::uint8_t> layer(layerSize(pieces), kUnsolvable);
+
+    // only boards in canonical form (see Symmetry) are solved; probe looks
+    // every other board up by its canonical form
+    forEachBoard(pieces, [&](std::uint64_t index, std::uint64_t packed, std::uint16_t occ) {
+      if (pieces == 1) {
+        layer[index] = kSolved;
+        return;
+      }
+      if (Symmetry::canonical(packed) != packed) {
+        return;
+      }
+      // the first capture into a solvable board wins
+      for (std::uint16_t rest = occ; rest != 0 && layer[index] == kUnsolvable;
+           rest &= rest - 1) {
+        const int from = __builtin_ctz(rest);
+        const auto mover = static_cast<PieceType::PieceType>((packed >> (4 * from)) & 0xF);
+        for (std::uint16_t captures = Attacks::captures(mover, from, occ);
+             captures != 0; captures &= captures - 1) {
+          const int to = __builtin_ctz(captures);
+          std::uint64_t next = packed & ~((0xFULL << (4 * from)) | (0xFULL << (4 * to)));
+          next |= static_cast<std::uint64_t>(mover) << (4 * to);
+          if (below[canonicalIndex(next, pieces - 1)] != kUnsolvable) {
+            layer[index] = static_cast<std::uint8_t>((from << 4) | to);
+            break;
+          }
+        }
+      }
+    });
+
+    file.write(reinterpret_cast<const char*>(layer.data()),
+               static_cast<std::streamsize>(layer.size()));
+    below.swap(layer);
+  }
+  return static_cast<bool>(file);
+}
+
+// memory-maps the tablebase file at 'path'; returns false (leaving the
+// tablebase closed) if it's missing or malformed
+bool Tablebase::open(const std::string& path) {
+  close();
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat info{};
+  if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(Header)) {
+    ::close(fd);
+    return false;
+  }
+  void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+
+  Header header;
+  std::memcpy(&header, mapping, sizeof(Header));
+  // version 1 files fill in every entry, version 2 only canonical ones; both
+  // read the same way
+  bool valid = std::memcmp(header.magic, "SCTB", 4) == 0 &&
+               (header.version == 1 || header.version == 2) &&
+               header.max_pieces >= 1 && header.max_pieces <= 16;
+  // every layer probe() can read from must lie inside the file
+  const auto size = static_cast<std::uint64_t>(info.st_size);
+  for (std::uint32_t pieces = 1; valid && pieces <= header.max_pieces; pieces++) {
+    const std::uint64_t offset = header.layer_offsets[pieces];
+    valid = offset >= sizeof(Header) && offset <= size && layerSize(pieces) <= size - offset;
+  }
+  if (!valid) {
+    std::cerr << "error: " << path << " is not a valid tablebase.\n";
+    munmap(mapping, info.st_size);
+    return false;
+  }
+
+  data_ = static_cast<const std::uint8_t*>(mapping);
+  size_ = info.st_size;
+  max_pieces_ = static_cast<int>(header.max_pieces);
+  layer_offsets_ = header.layer_offsets;
+  return true;
+}
+
+// opens the file named by $SOLITAIRE_CHESS_TABLEBASE, or else
+// "solitaire-chess.tb" in the working directory
+bool Tablebase::openDefault() {
+  const char* path = std::getenv("SOLITAIRE_CHESS_TABLEBASE");
+  return open(path != nullptr ? path : "solitaire-chess.tb");
+}
+
+void Tablebase::close() {
+  if (data_ != nullptr) {
+    munmap(const_cast<std::uint8_t*>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  max_pieces_ = 0;
+}
+
+bool Tablebase::isOpen() const {
+  return data_ != nullptr;
+}
+
+int Tablebase::getMaxPieces() const {
+  return max_pieces_;
+}
+
+// returns what the tablebase knows about 'board'
+Tablebase::Probe Tablebase::probe(const Chessboard& board) const {
+  const std::uint16_t occ = board.getOccupancy();
+  const int pieces = __builtin_popcount(occ);
+  if (data_ == nullptr || pieces == 0 || pieces > max_pieces_) {
+    return {false, false, Move{}, 0};
+  }
+
+  const std::uint64_t packed = board.getPacked();
+  const std::uint8_t entry = data_[layer_offsets_[pieces] + canonicalIndex(packed, pieces)];
+  if (entry == kUnsolvable) {
+    return {true, false, Move{}, 0};
+  }
+  // the capture is stored as played on the canonical board
+  const Move move = entry == kSolved
+                        ? Move{}
+                        : Symmetry::mapMove(Symmetry::inverse(Symmetry::transformTo(
+                                                packed, Symmetry::canonical(packed))),
+                                            Move{static_cast<std::uint8_t>(entry >> 4),
+                                                 static_cast<std::uint8_t>(entry & 0xF)});
+  return {true, true, move, pieces - 1};
+}
+
+
+
+/* HELPER or NON-MEMBER FUNCTIONS */
+
+namespace {
+
+  // calls 'visit(index, packed, occ)' for every board with 'pieces' pieces, in
+  // layer order: every set of squares in rank order (Gosper's hack), then
+  // every assignment of piece types to them in base-6 order
+  template <typename Visit>
+  void forEachBoard(int pieces, Visit visit) {
+    std::uint64_t index{0};
+    for (std::uint32_t squares = (1u << pieces) - 1; squares < (1u << 16);) {
+      const auto occ = static_cast<std::uint16_t>(squares);
+      for (std::uint64_t types = 0; types < kPowersOfSix[pieces]; types++, index++) {
+        std::uint64_t packed{0};
+        std::uint64_t digits{types};
+        for (std::uint16_t rest = occ; rest != 0; rest &= rest - 1, digits /= 6) {
+          packed |= (digits % 6 + 1) << (4 * __builtin_ctz(rest));
+        }
+        visit(index, packed, occ);
+      }
+
+      const std::uint32_t lowest = squares & -squares;
+      const std::uint32_t ripple = squares + lowest;
+      squares = (((ripple ^ squares) >> 2) / lowest) | ripple;
+    }
+  }
+
+  // returns the index of a board with 'pieces' pieces inside its layer
+  std::uint64_t layerIndex(std::uint64_t packed, std::uint16_t occ, int pieces) {
+    std::uint64_t rank{0}, types{0};
+    int i{0};
+    for (std::uint16_t rest = occ; rest != 0; rest &= rest - 1, i++) {
+      const int square = __builtin_ctz(rest);
+      rank += kChoose[square][i + 1];
+      types += (((packed >> (4 * square)) & 0xF) - 1) * kPowersOfSix[i];
+    }
+    return rank * kPowersOfSix[pieces] + types;
+  }
+
+  // returns the index of the canonical form (see Symmetry) of a board with
+  // 'pieces' pieces inside its layer
+  std::uint64_t canonicalIndex(std::uint64_t packed, int pieces) {
+    const std::uint64_t form = Symmetry::canonical(packed);
+    return layerIndex(form, Chessboard::occupancyOf(form), pieces);
+  }
+
+  // returns the number of boards with exactly 'pieces' pieces
+  std::uint64_t layerSize(int pieces) {
+    return kChoose[16][pieces] * kPowersOfSix[pieces];
+  }
+}
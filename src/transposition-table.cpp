@@ -0,0 +1,103 @@
+#include <algorithm>
+
+#include "../include/chessboard.hpp"
+#include "../include/stats.hpp"
+#include "../include/transposition-table.hpp"
+
+
+/* MEMBER FUNCTIONS */
+
+// constructor for the transposition table
+TranspositionTable::TranspositionTable(std::size_t kilobytes, Replacement replacement)
+    : replacement_(replacement) {
+  // largest power of two number of buckets within the budget (at least one)
+  std::size_t count{1};
+  while (count * 2 * sizeof(Bucket) <= kilobytes * 1024) {
+    count *= 2;
+  }
+  buckets_.resize(count);
+  mask_ = count - 1;
+  clear();
+}
+
+// returns the entry stored for 'board', or nullptr if there is none
+const TranspositionTable::Entry* TranspositionTable::probe(const Chessboard& board) const {
+  return probe(board.getPacked(), board.getHash());
+}
+
+// returns the entry stored for the packed position 'key', whose Zobrist hash is
+// 'hash', or nullptr if there is none
+const TranspositionTable::Entry* TranspositionTable::probe(std::uint64_t key,
+                                                           std::uint64_t hash) const {
+  for (const Entry& entry : bucketFor(hash).entries) {
+    if (entry.key == key) {
+      hits_++;
+      STATS_ADD(Stats::TABLE_HITS, 1);
+      return &entry;
+    }
+  }
+  misses_++;
+  STATS_ADD(Stats::TABLE_MISSES, 1);
+  return nullptr;
+}
+
+// stores 'entry' for 'board', evicting another position if its bucket is full
+void TranspositionTable::store(const Chessboard& board, Entry entry) {
+  store(board.getPacked(), board.getHash(), entry);
+}
+
+// stores 'entry' for the packed position 'key', whose Zobrist hash is 'hash',
+// evicting another position if its bucket is full
+void TranspositionTable::store(std::uint64_t key, std::uint64_t hash, Entry entry) {
+  entry.key = key;
+  std::array<Entry, 4>& entries = bucketFor(hash).entries;
+
+  // overwrites the position's own entry or the first free one
+  for (Entry& slot : entries) {
+    if (slot.key == entry.key || slot.key == 0) {
+      slot = entry;
+      return;
+    }
+  }
+
+  if (replacement_ == Replacement::ALWAYS) {
+    // entries are kept oldest-first, so the oldest drops off the front
+    std::move(entries.begin() + 1, entries.end(), entries.begin());
+    entries.back() = entry;
+  } else {
+    Entry* victim = &*std::min_element(
+        entries.begin(), entries.end(),
+        [](const Entry& a, const Entry& b) { return a.depth < b.depth; });
+    // keeps the more expensive result if the new one is cheaper
+    if (victim->depth <= entry.depth) {
+      *victim = entry;
+    }
+  }
+}
+
+void TranspositionTable::clear() {
+  std::fill(buckets_.begin(), buckets_.end(), Bucket{});
+  hits_ = misses_ = 0;
+}
+
+// returns the number of entries the table can hold
+std::size_t TranspositionTable::getCapacity() const {
+  return buckets_.size() * 4;
+}
+
+std::uint64_t TranspositionTable::getHits() const {
+  return hits_;
+}
+
+std::uint64_t TranspositionTable::getMisses() const {
+  return misses_;
+}
+
+// returns the bucket positions with the Zobrist hash 'hash' live in
+TranspositionTable::Bucket& TranspositionTable::bucketFor(std::uint64_t hash) {
+  return buckets_[hash & mask_];
+}
+
+const TranspositionTable::Bucket& TranspositionTable::bucketFor(std::uint64_t hash) const {
+  return buckets_[hash & mask_];
+}